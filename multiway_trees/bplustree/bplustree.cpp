@@ -3,9 +3,188 @@
 #include <string>
 #include <chrono>
 #include <fstream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <thread>
 #include "bplustree.hpp"
 using namespace std;
 
+template <class Tree>
+void report_comparator(Tree& tree, const char* name, const vector<int>& keys) {
+	using namespace std::chrono;
+
+	steady_clock::time_point start = steady_clock::now();
+	for (int key : keys) {
+		tree.insert(key);
+	}
+	double insert_time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+	uint64_t found = 0;
+	start = steady_clock::now();
+	for (int key : keys) {
+		found += tree.search(key).first != nullptr;
+	}
+	double search_time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+	std::cout << name << "\t" << insert_time << " ns\t\t" << search_time << " ns\t\t" << found << "\n";
+}
+
+bool compare(const int& a, const int& b);
+
+void benchmark_comparator(const uint32_t deg) {
+	vector<int> keys;
+	for (int i = -50000; i < 50000; i++) {
+		keys.push_back(i + 1);
+	}
+	shuffle(keys.begin(), keys.end(), mt19937(42));
+
+	BPTree pointer_tree(deg, compare);
+	BPTree<int> inlined_tree(deg);
+
+	std::cout << "\ncomparator\t\tinsert\t\tsearch\t\tfound\n";
+	report_comparator(pointer_tree, "function pointer", keys);
+	report_comparator(inlined_tree, "std::less\t", keys);
+}
+
+void report_allocator(const uint32_t deg, const char* name, std::pmr::memory_resource* upstream, const vector<int>& keys) {
+	using namespace std::chrono;
+
+	BPTree<int>* tree = new BPTree<int>(deg, less<int>(), nullptr, upstream);
+
+	steady_clock::time_point start = steady_clock::now();
+	for (int key : keys) {
+		tree->insert(key);
+	}
+	double insert_time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+	uint64_t memory = tree->memory_in_bytes();
+
+	start = steady_clock::now();
+	delete tree;
+	double teardown_time = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+	std::cout << name << "\t" << insert_time << " ns\t\t" << teardown_time << " ms\t\t" << memory << "\n";
+}
+
+void benchmark_allocator(const uint32_t deg) {
+	vector<int> keys;
+	for (int i = 0; i < 1000000; i++) {
+		keys.push_back(i);
+	}
+	shuffle(keys.begin(), keys.end(), mt19937(11));
+
+	std::pmr::unsynchronized_pool_resource pool_resource;
+	std::pmr::monotonic_buffer_resource arena_resource;
+
+	std::cout << "\nupstream\t\tinsert\t\tteardown\tnode memory (bytes)\n";
+	report_allocator(deg, "new / delete\t", std::pmr::new_delete_resource(), keys);
+	report_allocator(deg, "unsynchronized pool", &pool_resource, keys);
+	report_allocator(deg, "monotonic arena\t", &arena_resource, keys);
+}
+
+template <class Load>
+void report_bulk_load(const uint32_t deg, const char* name, Load load) {
+	using namespace std::chrono;
+
+	BPTree<int> tree(deg);
+
+	steady_clock::time_point start = steady_clock::now();
+	load(tree);
+	double time = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+	std::cout << name << "\t" << time << " ms\t\t" << tree.height() << "\t" << tree.memory_in_bytes() << "\n";
+}
+
+void benchmark_bulk_load(const uint32_t deg) {
+	vector<int> keys;
+	for (int i = 0; i < 1000000; i++) {
+		keys.push_back(i);
+	}
+
+	const uint32_t threads = max(1u, thread::hardware_concurrency());
+
+	std::cout << "\nloading\t\t\ttime\t\theight\tnode memory (bytes)\n";
+	report_bulk_load(deg, "repeated insert\t", [&](BPTree<int>& tree) {
+		for (int key : keys) {
+			tree.insert(key);
+		}
+	});
+	report_bulk_load(deg, "bulk load\t", [&](BPTree<int>& tree) {
+		tree.bulk_load(keys.begin(), keys.end());
+	});
+	report_bulk_load(deg, "bulk load (70% fill)", [&](BPTree<int>& tree) {
+		tree.bulk_load(keys.begin(), keys.end(), 0.7);
+	});
+	report_bulk_load(deg, "parallel bulk load", [&](BPTree<int>& tree) {
+		tree.bulk_load(keys.begin(), keys.end(), 1.0, threads);
+	});
+}
+
+void print(const int& x);
+
+template <class Lookup>
+void report_missing(const char* name, const vector<int>& probes, Lookup lookup) {
+	using namespace std::chrono;
+
+	uint64_t found = 0;
+	steady_clock::time_point start = steady_clock::now();
+	for (int probe : probes) {
+		found += lookup(probe);
+	}
+	double time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) probes.size();
+
+	std::cout << name << "\t" << time << " ns\t\t" << found << "\n";
+}
+
+void benchmark_missing(const uint32_t deg) {
+	BPTree<int> tree(deg, less<int>(), print);
+	for (int i = 0; i < 100000; i++) {
+		tree.insert(2 * i);
+	}
+
+	mt19937 prng(13);
+	vector<int> probes;
+	for (int i = 0; i < 1000000; i++) {
+		int key = prng() % 200000;
+		probes.push_back(prng() % 10 ? key bitor 1 : key & ~1);
+	}
+
+	std::cout << "\nlookup (90% misses)\tper probe\tfound\n";
+	report_missing("searchKey + catch", probes, [&](int key) {
+		try {
+			tree.searchKey(key);
+			return true;
+		}
+		catch (const out_of_range& exc) {
+			return false;
+		}
+	});
+	report_missing("find\t\t", probes, [&](int key) {
+		return tree.find(key).has_value();
+	});
+	report_missing("contains\t", probes, [&](int key) {
+		return tree.contains(key);
+	});
+
+	vector<int> misses(probes.begin(), probes.begin() + 100000);
+	for (int& key : misses) {
+		key = key bitor 1;
+	}
+
+	report_missing("remove + catch\t", misses, [&](int key) {
+		try {
+			tree.remove(key);
+			return true;
+		}
+		catch (const out_of_range& exc) {
+			return false;
+		}
+	});
+	report_missing("try_remove\t", misses, [&](int key) {
+		return bool(tree.try_remove(key));
+	});
+}
+
 void benchmark(BPTree<int>& tree) {
 	using namespace std::chrono;
 
@@ -25,6 +204,7 @@ void benchmark(BPTree<int>& tree) {
 	std::cout << "\nnumber of keys: " << tree.num_keys();
     std::cout << "\nsize of tree (bytes): " << tree.size_in_bytes();
     std::cout << "\naverage size per key (bytes): " << (double)tree.size_in_bytes() / tree.num_keys();
+    std::cout << "\nnode memory (bytes): " << tree.memory_in_bytes() << " (" << (double)tree.memory_in_bytes() / tree.num_keys() << " per key)";
     std::cout << "\naverage key insertion time: " << time << " ns\n";
 
 	int input;
@@ -64,7 +244,12 @@ int main(void) {
 		cout << "minimum degree of btree: ";
 		cin >> deg;
 
-        BPTree<int> tree(deg, compare, print);
+        benchmark_comparator(deg);
+        benchmark_allocator(deg);
+        benchmark_bulk_load(deg);
+        benchmark_missing(deg);
+
+        BPTree<int> tree(deg, less<int>(), print);
         benchmark(tree);
         return 0;
     }
@@ -1,7 +1,19 @@
 #pragma once
 
+#include <cstdint>
+#include <cstddef>
 #include <utility>
 #include <sstream>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <new>
+#include <vector>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "nodepool.hpp"
 
 #ifndef _BPLUSTREE_NOT_MODIFIED
 	#define _BPLUSTREE_NOT_MODIFIED 0
@@ -15,15 +27,41 @@
 	#define _BPLUSTREE_NEW_ROOT 2
 #endif
 
-typedef unsigned char uint8_t;
-typedef unsigned short uint16_t;
-typedef unsigned int uint32_t;
-typedef unsigned long long uint64_t;
-typedef unsigned int size_t;
+#ifndef _BPLUSTREE_NODE_ALIGNMENT
+	#define _BPLUSTREE_NODE_ALIGNMENT 64
+#endif
 
-template <typename _Tp> class BPTree;
+#ifndef _BPLUSTREE_MAX_DEPTH
+	#define _BPLUSTREE_MAX_DEPTH 32
+#endif
 
-template <typename _Tp> std::ostream& operator<<(std::ostream&, const BPTree<_Tp>&);
+template <typename _Tp, typename = void>
+struct BPTreeKeyTraits {
+    static constexpr bool fixed_width = false;
+};
+
+template <typename _Tp>
+struct BPTreeKeyTraits<_Tp, typename std::enable_if<std::is_integral<_Tp>::value>::type> {
+    static constexpr bool fixed_width = true;
+    static constexpr uint32_t width = sizeof(_Tp);
+};
+
+template <typename _Tp>
+class BPTreeLessThan {
+    private:
+        bool (*lessThan)(const _Tp&, const _Tp&);
+
+    public:
+        BPTreeLessThan(bool (*compare)(const _Tp&, const _Tp&)) : lessThan(compare) {}
+
+        bool operator()(const _Tp& a, const _Tp& b) const {
+            return lessThan(a, b);
+        }
+};
+
+template <typename _Tp, class Compare = std::less<_Tp>, class KeyTraits = BPTreeKeyTraits<_Tp>> class BPTree;
+
+template <typename _Tp, class Cmp, class KT> std::ostream& operator<<(std::ostream&, const BPTree<_Tp, Cmp, KT>&);
 
 template <typename _Tp>
 class BPNode {
@@ -33,42 +71,70 @@ class BPNode {
         uint32_t size;
         bool leaf;
 
-        void deepClean(void) noexcept;
+        template <typename, class, class> friend class BPTree;
+
+        static constexpr uint64_t keyOffset(void) noexcept;
 
-        friend class BPTree<_Tp>;
+        static uint64_t childOffset(const uint32_t) noexcept;
+
+        BPNode(const uint32_t, const bool) noexcept;
+
+        ~BPNode(void) = default;
 
     public:
-	    explicit BPNode(const uint32_t);
+        static uint64_t blockSize(const uint32_t) noexcept;
+
+        static BPNode* create(void*, const uint32_t, const bool) noexcept;
 
-        ~BPNode(void);
+        static void destroy(BPNode*, const uint32_t) noexcept;
 };
 
-template <typename _Tp>
+template <typename _Tp, class Compare, class KeyTraits>
 class BPTree {
     private:
         BPNode<_Tp>* root;
         const uint32_t minDegree;
 
-        bool (*lessThan)(const _Tp&, const _Tp&) noexcept;
-        void (*printKey)(const _Tp&) noexcept;
+        Compare lessThan;
+        void (*printKey)(const _Tp&);
 
         uint32_t keyCount;
         uint32_t heightCount;
-        
-        void copyNode(BPNode<_Tp>*, const BPNode<_Tp>*) noexcept;
+        uint64_t nodeBytes;
+
+        NodePool nodePool;
+
+        BPNode<_Tp>* allocateNode(const bool);
+
+        void releaseNode(BPNode<_Tp>*) noexcept;
+
+        bool equal(const _Tp&, const _Tp&) const noexcept;
+
+        void copyNode(BPNode<_Tp>*&, const BPNode<_Tp>*, BPNode<_Tp>*&) noexcept;
 
         void freeNode(BPNode<_Tp>*);
 
+        void clear(void) noexcept;
+
         BPNode<_Tp>* findParent(BPNode<_Tp>*, const BPNode<_Tp>*) const noexcept;
 
-        uint8_t insertInternal(const _Tp, BPNode<_Tp>*, BPNode<_Tp>*) noexcept;
+        uint8_t insertInternal(const _Tp, BPNode<_Tp>*, const BPNode<_Tp>*, BPNode<_Tp>*) noexcept;
 
-        uint8_t removeInternal(_Tp, BPNode<_Tp>*, BPNode<_Tp>*) noexcept;
+        uint8_t rebalance(BPNode<_Tp>*, uint32_t) noexcept;
 
         void printNode(std::ostream&, const BPNode<_Tp>*, const uint32_t) const noexcept;
 
+        [[noreturn]] void missingKey(const _Tp&) const;
+
+        static uint64_t packCount(const uint64_t, const uint32_t, const uint32_t, const uint32_t) noexcept;
+
+        template <class Iterator>
+        void packLeaves(Iterator, const uint64_t, const uint64_t, const uint64_t, const uint64_t, std::vector<BPNode<_Tp>*>&, std::vector<_Tp>&);
+
     public:
-        explicit BPTree(const uint32_t, bool (*)(const _Tp&, const _Tp&), void (*)(const _Tp&) = nullptr);
+        explicit BPTree(const uint32_t, const Compare& = Compare(), void (*)(const _Tp&) = nullptr, std::pmr::memory_resource* = std::pmr::get_default_resource());
+
+        explicit BPTree(const uint32_t, bool (*)(const _Tp&, const _Tp&), void (*)(const _Tp&) = nullptr, std::pmr::memory_resource* = std::pmr::get_default_resource());
 
         ~BPTree(void);
 
@@ -82,83 +148,160 @@ class BPTree {
 
         constexpr uint64_t size_in_bytes(void) const noexcept;
 
+        constexpr uint64_t memory_in_bytes(void) const noexcept;
+
         void insert(const _Tp) noexcept;
 
+        template <class Iterator>
+        void bulk_load(Iterator, Iterator, const double = 1.0, const uint32_t = 1);
+
         void remove(const _Tp);
 
+        bool try_remove(const _Tp) noexcept;
+
         std::pair<const BPNode<_Tp>*, uint32_t> search(const _Tp) const noexcept;
 
+        std::optional<_Tp> find(const _Tp) const noexcept;
+
+        bool contains(const _Tp) const noexcept;
+
         _Tp searchKey(const _Tp key) const;
 
-        friend std::ostream& operator<< <>(std::ostream&, const BPTree<_Tp>&);
+        friend std::ostream& operator<< <>(std::ostream&, const BPTree&);
 };
 
 template <typename _Tp>
-BPNode<_Tp>::BPNode(const uint32_t minDegree)
-    : size(0), leaf(true) {
-	key = new _Tp[2 * minDegree - 1];
-	child = new BPNode<_Tp>*[2 * minDegree];
+BPTree(const uint32_t, bool (*)(const _Tp&, const _Tp&), void (*)(const _Tp&) = nullptr, std::pmr::memory_resource* = std::pmr::get_default_resource()) -> BPTree<_Tp, BPTreeLessThan<_Tp>>;
+
+template <typename _Tp>
+constexpr uint64_t BPNode<_Tp>::keyOffset(void) noexcept {
+    return (sizeof(BPNode) + alignof(_Tp) - 1) / alignof(_Tp) * alignof(_Tp);
+}
 
+template <typename _Tp>
+uint64_t BPNode<_Tp>::childOffset(const uint32_t minDegree) noexcept {
+    const uint64_t keysEnd = keyOffset() + (2 * minDegree - 1) * sizeof(_Tp);
+    return (keysEnd + alignof(BPNode*) - 1) / alignof(BPNode*) * alignof(BPNode*);
+}
+
+template <typename _Tp>
+uint64_t BPNode<_Tp>::blockSize(const uint32_t minDegree) noexcept {
+    const uint64_t bytes = childOffset(minDegree) + 2 * minDegree * sizeof(BPNode*);
+    return (bytes + _BPLUSTREE_NODE_ALIGNMENT - 1) / _BPLUSTREE_NODE_ALIGNMENT * _BPLUSTREE_NODE_ALIGNMENT;
+}
+
+template <typename _Tp>
+BPNode<_Tp>::BPNode(const uint32_t minDegree, const bool isLeaf) noexcept
+    : size(0), leaf(isLeaf) {
+    key = reinterpret_cast<_Tp*>(reinterpret_cast<char*>(this) + keyOffset());
+    for (uint32_t i = 0; i < 2 * minDegree - 1; i++) {
+        new (key + i) _Tp();
+    }
+
+    child = reinterpret_cast<BPNode**>(reinterpret_cast<char*>(this) + childOffset(minDegree));
     for (uint32_t i = 0; i < 2 * minDegree; i++) {
         child[i] = nullptr;
     }
 }
 
 template <typename _Tp>
-BPNode<_Tp>::~BPNode(void) {
-    delete[] child;
-    delete[] key;
+BPNode<_Tp>* BPNode<_Tp>::create(void* block, const uint32_t minDegree, const bool leaf) noexcept {
+    return new (block) BPNode(minDegree, leaf);
 }
 
 template <typename _Tp>
-void BPNode<_Tp>::deepClean(void) noexcept {
-    if (not leaf) {
-        for (uint32_t i = 0; i <= size; i++) {
-            child[i]->deepClean();
-        }
+void BPNode<_Tp>::destroy(BPNode* node, const uint32_t minDegree) noexcept {
+    for (uint32_t i = 0; i < 2 * minDegree - 1; i++) {
+        node->key[i].~_Tp();
     }
 
-    delete[] child;
-    delete[] key;
+    node->~BPNode();
 }
 
-template <typename _Tp>
-BPTree<_Tp>::BPTree(const uint32_t deg, bool (*compare)(const _Tp&, const _Tp&), void (*printK)(const _Tp&))
-    : minDegree(deg), lessThan(compare), printKey(printK), keyCount(0), heightCount(0) {
+template <typename _Tp, class Cmp, class KT>
+BPTree<_Tp, Cmp, KT>::BPTree(const uint32_t deg, const Cmp& compare, void (*printK)(const _Tp&), std::pmr::memory_resource* upstream)
+    : minDegree(deg), lessThan(compare), printKey(printK), keyCount(0), heightCount(0), nodeBytes(0),
+    nodePool(BPNode<_Tp>::blockSize(deg), _BPLUSTREE_NODE_ALIGNMENT, upstream) {
 	root = nullptr;
 }
 
-template <typename _Tp>
-BPTree<_Tp>::~BPTree(void) {
-	freeNode(root);
+template <typename _Tp, class Cmp, class KT>
+BPTree<_Tp, Cmp, KT>::BPTree(const uint32_t deg, bool (*compare)(const _Tp&, const _Tp&), void (*printK)(const _Tp&), std::pmr::memory_resource* upstream)
+    : minDegree(deg), lessThan(compare), printKey(printK), keyCount(0), heightCount(0), nodeBytes(0),
+    nodePool(BPNode<_Tp>::blockSize(deg), _BPLUSTREE_NODE_ALIGNMENT, upstream) {
+    static_assert(std::is_constructible<Cmp, bool (*)(const _Tp&, const _Tp&)>::value, "function-pointer comparators need Compare = BPTreeLessThan<_Tp>; declare the tree as BPTree tree(deg, compare)");
+	root = nullptr;
 }
 
-template <typename _Tp>
-BPTree<_Tp>::BPTree(const BPTree& bptree)
+template <typename _Tp, class Cmp, class KT>
+BPTree<_Tp, Cmp, KT>::~BPTree(void) {
+	clear();
+}
+
+template <typename _Tp, class Cmp, class KT>
+BPTree<_Tp, Cmp, KT>::BPTree(const BPTree& bptree)
     : minDegree(bptree.minDegree), lessThan(bptree.lessThan), printKey(bptree.printKey),
-    keyCount(bptree.keyCount), heightCount(bptree.heightCount) {
-    copyNode(root, bptree.root);
+    keyCount(bptree.keyCount), heightCount(bptree.heightCount), nodeBytes(0),
+    nodePool(bptree.nodePool.block_size(), _BPLUSTREE_NODE_ALIGNMENT, bptree.nodePool.upstream_resource()) {
+    BPNode<_Tp>* lastLeaf = nullptr;
+    copyNode(root, bptree.root, lastLeaf);
 }
 
-template <typename _Tp>
-BPTree<_Tp>& BPTree<_Tp>::operator=(const BPTree& bptree) {
+template <typename _Tp, class Cmp, class KT>
+BPTree<_Tp, Cmp, KT>& BPTree<_Tp, Cmp, KT>::operator=(const BPTree& bptree) {
     if (minDegree != bptree.minDegree) {
         throw std::bad_alloc();
     }
 
+    if (this == &bptree) {
+        return *this;
+    }
+
+    clear();
     keyCount = bptree.keyCount;
     heightCount = bptree.heightCount;
-    freeNode(root);
-    copyNode(root, bptree.root);
+
+    BPNode<_Tp>* lastLeaf = nullptr;
+    copyNode(root, bptree.root, lastLeaf);
 
     return *this;
 }
 
-template <typename _Tp>
-void BPTree<_Tp>::copyNode(BPNode<_Tp>* dest, const BPNode<_Tp>* src) noexcept {
-    dest = new BPNode<_Tp>(minDegree);
+template <typename _Tp, class Cmp, class KT>
+BPNode<_Tp>* BPTree<_Tp, Cmp, KT>::allocateNode(const bool leaf) {
+    nodeBytes += nodePool.block_size();
+    return BPNode<_Tp>::create(nodePool.allocate_block(), minDegree, leaf);
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BPTree<_Tp, Cmp, KT>::releaseNode(BPNode<_Tp>* node) noexcept {
+    nodeBytes -= nodePool.block_size();
+    BPNode<_Tp>::destroy(node, minDegree);
+    nodePool.release_block(node);
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BPTree<_Tp, Cmp, KT>::clear(void) noexcept {
+    if constexpr (not std::is_trivially_destructible<_Tp>::value) {
+        if (root != nullptr) {
+            freeNode(root);
+        }
+    }
+
+    nodePool.release_all();
+    nodeBytes = 0;
+    root = nullptr;
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BPTree<_Tp, Cmp, KT>::copyNode(BPNode<_Tp>*& dest, const BPNode<_Tp>* src, BPNode<_Tp>*& lastLeaf) noexcept {
+    if (src == nullptr) {
+        dest = nullptr;
+        return;
+    }
+
+    dest = allocateNode(src->leaf);
     dest->size = src->size;
-    dest->leaf = src->leaf;
 
     for (uint32_t i = 0; i < src->size; i++) {
         dest->key[i] = src->key[i];
@@ -166,13 +309,32 @@ void BPTree<_Tp>::copyNode(BPNode<_Tp>* dest, const BPNode<_Tp>* src) noexcept {
 
 	if (not src->leaf) {
 		for (uint32_t i = 0; i <= src->size; i++) {
-			copyNode(dest->child[i], src->child[i]);
+			copyNode(dest->child[i], src->child[i], lastLeaf);
 		}
 	}
+
+    else {
+        if (lastLeaf != nullptr) {
+            lastLeaf->child[lastLeaf->size] = dest;
+        }
+
+        lastLeaf = dest;
+    }
 }
 
-template <typename _Tp>
-void BPTree<_Tp>::freeNode(BPNode<_Tp>* node) {
+template <typename _Tp, class Cmp, class KT>
+bool BPTree<_Tp, Cmp, KT>::equal(const _Tp& a, const _Tp& b) const noexcept {
+    if constexpr (KT::fixed_width and std::is_same<Cmp, std::less<_Tp>>::value) {
+        return a == b;
+    }
+
+    else {
+        return not (lessThan(a, b) or lessThan(b, a));
+    }
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BPTree<_Tp, Cmp, KT>::freeNode(BPNode<_Tp>* node) {
 	if (node == nullptr) {
         throw std::runtime_error("nullptr bad deallocation");
     }
@@ -183,16 +345,16 @@ void BPTree<_Tp>::freeNode(BPNode<_Tp>* node) {
 		}
 	}
 
-	delete node;
+	releaseNode(node);
 }
 
-template <typename _Tp>
-BPNode<_Tp>* BPTree<_Tp>::findParent(BPNode<_Tp>* curr, const BPNode<_Tp>* child) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+BPNode<_Tp>* BPTree<_Tp, Cmp, KT>::findParent(BPNode<_Tp>* curr, const BPNode<_Tp>* child) const noexcept {
 	if (curr->leaf or (curr->child[0])->leaf) {
 		return nullptr;
 	}
 
-    BPNode<_Tp>* par;
+    BPNode<_Tp>* par = nullptr;
 	for (uint32_t i = 0; i < curr->size+1; i++) {
 		if(curr->child[i] == child) {
 			par = curr;
@@ -210,13 +372,15 @@ BPNode<_Tp>* BPTree<_Tp>::findParent(BPNode<_Tp>* curr, const BPNode<_Tp>* child
 	return par;
 }
 
-template <typename _Tp>
-uint8_t BPTree<_Tp>::insertInternal(const _Tp key, BPNode<_Tp>* curr, BPNode<_Tp>* child) noexcept {
+template <typename _Tp, class Cmp, class KT>
+uint8_t BPTree<_Tp, Cmp, KT>::insertInternal(const _Tp key, BPNode<_Tp>* curr, const BPNode<_Tp>* left, BPNode<_Tp>* child) noexcept {
+	uint32_t pos = 0;
+	while (curr->child[pos] != left) {
+		pos++;
+	}
+
 	if (curr->size < 2 * minDegree - 1) {
-		uint32_t i = 0;
-		while (lessThan(curr->key[i], key) and i < curr->size) {
-            i++;
-        }
+		uint32_t i = pos;
 
 		for (uint32_t j = curr->size; j > i; j--) {
 			curr->key[j] = curr->key[j - 1];
@@ -234,7 +398,7 @@ uint8_t BPTree<_Tp>::insertInternal(const _Tp key, BPNode<_Tp>* curr, BPNode<_Tp
 	}
 
 	else {
-		BPNode<_Tp>* newInternal = new BPNode<_Tp>(minDegree);
+		BPNode<_Tp>* newInternal = allocateNode(false);
 
 		_Tp virtualKey[2 * minDegree];
 		BPNode<_Tp>* virtualChild[2 * minDegree + 1];
@@ -243,30 +407,30 @@ uint8_t BPTree<_Tp>::insertInternal(const _Tp key, BPNode<_Tp>* curr, BPNode<_Tp
 			virtualKey[i] = curr->key[i];
 		}
 
-		for (int i = 0; i < 2 * minDegree; i++) {
+		for (uint32_t i = 0; i < 2 * minDegree; i++) {
 			virtualChild[i] = curr->child[i];
 		}
 
-		uint32_t i = 0, j;
-		while (lessThan(virtualKey[i], key) and i < 2 * minDegree - 1) {
-            i++;
-        }
-
-		for (uint32_t j = 2 * minDegree; j > i; j--) {
+		uint32_t i = pos, j;
+		for (uint32_t j = 2 * minDegree - 1; j > i; j--) {
 			virtualKey[j] = virtualKey[j - 1];
 		}
 
 		virtualKey[i] = key; 
-		for(uint32_t j = 2 * minDegree + 1; j > i + 1; j--) {
+		for(uint32_t j = 2 * minDegree; j > i + 1; j--) {
 			virtualChild[j] = virtualChild[j - 1];
 		}
 
 		virtualChild[i + 1] = child; 
-		newInternal->leaf = false;
 
 		curr->size = minDegree;
 		newInternal->size = minDegree - 1;
 
+		for (i = 0; i <= curr->size; i++) {
+			curr->key[i] = virtualKey[i];
+			curr->child[i] = virtualChild[i];
+		}
+
 		for(i = 0, j = curr->size + 1; i < newInternal->size; i++, j++) {
 			newInternal->key[i] = virtualKey[j];
 		}
@@ -278,172 +442,157 @@ uint8_t BPTree<_Tp>::insertInternal(const _Tp key, BPNode<_Tp>* curr, BPNode<_Tp
 
 		if(curr == root)
 		{
-			BPNode<_Tp>* newRoot = new BPNode<_Tp>(minDegree);
-			newRoot->leaf = false;
+			BPNode<_Tp>* newRoot = allocateNode(false);
 			newRoot->key[0] = curr->key[curr->size];
 			newRoot->child[0] = curr;
 			newRoot->child[1] = newInternal;
 			newRoot->size += 1;
 			root = newRoot;
+			heightCount++;
 
             return _BPLUSTREE_NEW_ROOT;
 		}
 
 		else {
-			return insertInternal(curr->key[curr->size], findParent(root, curr), newInternal);
+			return insertInternal(curr->key[curr->size], findParent(root, curr), curr, newInternal);
 		}
 	}
 }
 
-template <typename _Tp>
-uint8_t BPTree<_Tp>::removeInternal(const _Tp key, BPNode<_Tp>* curr, BPNode<_Tp>* child) noexcept {
-	if (curr == root) {
-		if (curr->size == 1) {
-			if (curr->child[1] == child) {
-				delete child;
-				root = curr->child[0];
-				delete curr;
-			}
-
-			else if (curr->child[0] == child) {
-				delete child;
-				root = curr->child[1];
-				delete curr;
-			}
-
-            heightCount--;
-            return _BPLUSTREE_NEW_ROOT;
-		}
-	}
+template <typename _Tp, class Cmp, class KT>
+uint8_t BPTree<_Tp, Cmp, KT>::rebalance(BPNode<_Tp>* par, uint32_t index) noexcept {
+    BPNode<_Tp>* curr = par->child[index];
+    BPNode<_Tp>* leftBPNode = index > 0 ? par->child[index - 1] : nullptr;
+    BPNode<_Tp>* rightBPNode = index < par->size ? par->child[index + 1] : nullptr;
 
-	uint32_t index;
-	for (index = 0; index < curr->size; index++) {
-		if(index < curr->size and not (lessThan(curr->key[index], key) or lessThan(key, curr->key[index]))) {
-			break;
-		}
-	}
+    if (curr->leaf) {
+        if (leftBPNode != nullptr and leftBPNode->size > minDegree) {
+            for (uint32_t i = curr->size; i > 0; i--) {
+                curr->key[i] = curr->key[i - 1];
+            }
 
-	for (uint32_t i = index; i < curr->size; i++) {
-		curr->key[i] = curr->key[i + 1];
-	}
+            curr->child[curr->size + 1] = curr->child[curr->size];
+            curr->child[curr->size] = nullptr;
+            curr->key[0] = leftBPNode->key[leftBPNode->size - 1];
+            curr->size++;
 
-	for (index = 0; index < curr->size + 1; index++) {
-		if(curr->child[index] == child) {
-			break;
-		}
-	}
+            leftBPNode->size--;
+            leftBPNode->child[leftBPNode->size] = curr;
+            leftBPNode->child[leftBPNode->size + 1] = nullptr;
 
-	for (uint32_t i = index; i < curr->size + 1; i++) {
-		curr->child[i] = curr->child[i + 1];
-	}
+            par->key[index - 1] = curr->key[0];
+            return _BPLUSTREE_NOT_MODIFIED;
+        }
 
-	curr->size--;
-	if (curr->size >= minDegree - 1) {
-		return _BPLUSTREE_MODIFIED_NOT_ROOT;
-	}
+        if (rightBPNode != nullptr and rightBPNode->size > minDegree) {
+            curr->key[curr->size] = rightBPNode->key[0];
+            curr->child[curr->size + 1] = curr->child[curr->size];
+            curr->child[curr->size] = nullptr;
+            curr->size++;
 
-	if (curr == root) {
-        return _BPLUSTREE_NOT_MODIFIED;
-    }
+            for (uint32_t i = 0; i + 1 < rightBPNode->size; i++) {
+                rightBPNode->key[i] = rightBPNode->key[i + 1];
+            }
 
-	BPNode<_Tp>* par = findParent(root, curr);
-	uint32_t leftSibling, rightSibling;
+            rightBPNode->size--;
+            rightBPNode->child[rightBPNode->size] = rightBPNode->child[rightBPNode->size + 1];
+            rightBPNode->child[rightBPNode->size + 1] = nullptr;
 
-	for (index = 0; index < par->size + 1; index++) {
-		if (par->child[index] == curr) {
-			leftSibling = index - 1;
-			rightSibling = index + 1;
-			break;
-		}
-	}
+            par->key[index] = rightBPNode->key[0];
+            return _BPLUSTREE_NOT_MODIFIED;
+        }
 
-	if (leftSibling >= 0) {
-		BPNode<_Tp>* leftBPNode = par->child[leftSibling];
+        if (leftBPNode == nullptr) {
+            leftBPNode = curr;
+            curr = rightBPNode;
+            index++;
+        }
 
-		if (leftBPNode->size >= minDegree) {
-			for (uint32_t i = curr->size; i > 0; i--) {
-				curr->key[i] = curr->key[i - 1];
-			}
+        leftBPNode->child[leftBPNode->size] = nullptr;
+        for (uint32_t j = 0; j < curr->size; j++) {
+            leftBPNode->key[leftBPNode->size + j] = curr->key[j];
+        }
 
-			curr->key[0] = par->key[leftSibling];
-			par->key[leftSibling] = leftBPNode->key[leftBPNode->size - 1];
+        leftBPNode->size += curr->size;
+        leftBPNode->child[leftBPNode->size] = curr->child[curr->size];
+    }
 
-			for (int i = curr->size + 1; i > 0; i--) {
-				curr->child[i] = curr->child[i - 1];
-			}
+    else {
+        if (leftBPNode != nullptr and leftBPNode->size >= minDegree) {
+            for (uint32_t i = curr->size; i > 0; i--) {
+                curr->key[i] = curr->key[i - 1];
+            }
 
-			curr->child[0] = leftBPNode->child[leftBPNode->size];
-			curr->size++;
-			leftBPNode->size--;
+            for (uint32_t i = curr->size + 1; i > 0; i--) {
+                curr->child[i] = curr->child[i - 1];
+            }
 
-			return _BPLUSTREE_MODIFIED_NOT_ROOT;
-		}
-	}
+            curr->key[0] = par->key[index - 1];
+            curr->child[0] = leftBPNode->child[leftBPNode->size];
+            curr->size++;
 
-	if (rightSibling <= par->size) {
-		BPNode<_Tp>* rightBPNode = par->child[rightSibling];
+            par->key[index - 1] = leftBPNode->key[leftBPNode->size - 1];
+            leftBPNode->child[leftBPNode->size] = nullptr;
+            leftBPNode->size--;
 
-		if (rightBPNode->size >= minDegree) {
-			curr->key[curr->size] = par->key[index];
-			par->key[index] = rightBPNode->key[0];
+            return _BPLUSTREE_NOT_MODIFIED;
+        }
 
-			for (uint32_t i = 0; i < rightBPNode->size - 1; i++) {
-				rightBPNode->key[i] = rightBPNode->key[i + 1];
-			}
+        if (rightBPNode != nullptr and rightBPNode->size >= minDegree) {
+            curr->key[curr->size] = par->key[index];
+            curr->child[curr->size + 1] = rightBPNode->child[0];
+            curr->size++;
 
-			curr->child[curr->size + 1] = rightBPNode->child[0];
-			for (uint32_t i = 0; i < rightBPNode->size; ++i) {
-				rightBPNode->child[i] = rightBPNode->child[i + 1];
-			}
+            par->key[index] = rightBPNode->key[0];
+            for (uint32_t i = 0; i + 1 < rightBPNode->size; i++) {
+                rightBPNode->key[i] = rightBPNode->key[i + 1];
+            }
 
-			curr->size++;
-			rightBPNode->size--;
-			
-            return _BPLUSTREE_MODIFIED_NOT_ROOT;
-		}
-	}
+            for (uint32_t i = 0; i < rightBPNode->size; i++) {
+                rightBPNode->child[i] = rightBPNode->child[i + 1];
+            }
 
-	if (leftSibling >= 0) {
-		BPNode<_Tp>* leftBPNode = par->child[leftSibling];
-		leftBPNode->key[leftBPNode->size] = par->key[leftSibling];
+            rightBPNode->child[rightBPNode->size] = nullptr;
+            rightBPNode->size--;
 
-		for (uint32_t i = leftBPNode->size + 1, j = 0; j < curr->size; j++) {
-			leftBPNode->key[i] = curr->key[j];
-		}
+            return _BPLUSTREE_NOT_MODIFIED;
+        }
 
-		for (uint32_t i = leftBPNode->size + 1, j = 0; j < curr->size + 1; j++) {
-			leftBPNode->child[i] = curr->child[j];
-			curr->child[j] = nullptr;
-		}
+        if (leftBPNode == nullptr) {
+            leftBPNode = curr;
+            curr = rightBPNode;
+            index++;
+        }
 
-		leftBPNode->size += curr->size + 1;
-		curr->size = 0;
+        leftBPNode->key[leftBPNode->size] = par->key[index - 1];
+        for (uint32_t j = 0; j < curr->size; j++) {
+            leftBPNode->key[leftBPNode->size + 1 + j] = curr->key[j];
+        }
 
-		return removeInternal(par->key[leftSibling], par, curr);
-	}
+        for (uint32_t j = 0; j <= curr->size; j++) {
+            leftBPNode->child[leftBPNode->size + 1 + j] = curr->child[j];
+        }
 
-	else if (rightSibling <= par->size) {
-		BPNode<_Tp>* rightBPNode = par->child[rightSibling];
-		curr->key[curr->size] = par->key[rightSibling - 1];
+        leftBPNode->size += curr->size + 1;
+    }
 
-		for (uint32_t i = curr->size+1, j = 0; j < rightBPNode->size; j++) {
-			curr->key[i] = rightBPNode->key[j];
-		}
+    for (uint32_t i = index - 1; i + 1 < par->size; i++) {
+        par->key[i] = par->key[i + 1];
+    }
 
-		for (uint32_t i = curr->size+1, j = 0; j < rightBPNode->size + 1; j++) {
-			curr->child[i] = rightBPNode->child[j];
-			rightBPNode->child[j] = nullptr;
-		}
+    for (uint32_t i = index; i < par->size; i++) {
+        par->child[i] = par->child[i + 1];
+    }
 
-		curr->size += rightBPNode->size + 1;
-		rightBPNode->size = 0;
+    par->child[par->size] = nullptr;
+    par->size--;
+    releaseNode(curr);
 
-		removeInternal(par->key[rightSibling - 1], par, rightBPNode);
-	}
+    return _BPLUSTREE_MODIFIED_NOT_ROOT;
 }
 
-template <typename _Tp>
-void BPTree<_Tp>::printNode(std::ostream& out, const BPNode<_Tp>* node, const uint32_t indent) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+void BPTree<_Tp, Cmp, KT>::printNode(std::ostream& out, const BPNode<_Tp>* node, const uint32_t indent) const noexcept {
     if (node == nullptr) {
         return;;
     }
@@ -465,32 +614,50 @@ void BPTree<_Tp>::printNode(std::ostream& out, const BPNode<_Tp>* node, const ui
 	}
 }
 
-template <typename _Tp>
-constexpr uint32_t BPTree<_Tp>::num_keys(void) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+void BPTree<_Tp, Cmp, KT>::missingKey(const _Tp& key) const {
+    if (printKey == nullptr) {
+        throw std::out_of_range("_BPLUSTREE_KEY_NOT_FOUND");
+    }
+
+    std::stringstream newbuf;
+    std::streambuf* oldbuf = std::cout.rdbuf(newbuf.rdbuf());
+    printKey(key);
+    std::cout.rdbuf(oldbuf);
+    throw std::out_of_range("_BPLUSTREE_KEY_NOT_FOUND: " + newbuf.str());
+}
+
+template <typename _Tp, class Cmp, class KT>
+constexpr uint32_t BPTree<_Tp, Cmp, KT>::num_keys(void) const noexcept {
     return keyCount;
 }
 
-template <typename _Tp>
-constexpr uint32_t BPTree<_Tp>::height(void) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+constexpr uint32_t BPTree<_Tp, Cmp, KT>::height(void) const noexcept {
     return heightCount;
 }
 
-template <typename _Tp>
-constexpr uint64_t BPTree<_Tp>::size_in_bytes(void) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+constexpr uint64_t BPTree<_Tp, Cmp, KT>::size_in_bytes(void) const noexcept {
     return keyCount * sizeof(_Tp);
 }
 
-template <typename _Tp>
-void BPTree<_Tp>::insert(const _Tp key) noexcept {
+template <typename _Tp, class Cmp, class KT>
+constexpr uint64_t BPTree<_Tp, Cmp, KT>::memory_in_bytes(void) const noexcept {
+    return nodeBytes;
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BPTree<_Tp, Cmp, KT>::insert(const _Tp key) noexcept {
 	if (root == nullptr) {
-		root = new BPNode<_Tp>(minDegree);
+		root = allocateNode(true);
 		root->key[0] = key;
 		root->size++;
 	}
 
 	else {
 		BPNode<_Tp>* curr = root;
-		BPNode<_Tp>* par;
+		BPNode<_Tp>* par = nullptr;
 
 		while (curr->leaf == false) {
 			par = curr;
@@ -509,7 +676,7 @@ void BPTree<_Tp>::insert(const _Tp key) noexcept {
 
 		if (curr->size < 2 * minDegree - 1) {
 			uint32_t i = 0;
-			while (lessThan(curr->key[i], key) and i < curr->size) {
+			while (i < curr->size and lessThan(curr->key[i], key)) {
                 i++;
             }
 
@@ -524,7 +691,7 @@ void BPTree<_Tp>::insert(const _Tp key) noexcept {
 		}
 
 		else {
-			BPNode<_Tp>* newLeaf = new BPNode<_Tp>(minDegree);
+			BPNode<_Tp>* newLeaf = allocateNode(true);
 
 			_Tp virtualBPNode[2 * minDegree];
 			for (uint32_t i = 0; i < 2 * minDegree - 1; i++) {
@@ -532,11 +699,11 @@ void BPTree<_Tp>::insert(const _Tp key) noexcept {
 			}
 
 			uint32_t i = 0, j;
-			while (lessThan(virtualBPNode[i], key) and i < 2 * minDegree - 1) {
+			while (i < 2 * minDegree - 1 and lessThan(virtualBPNode[i], key)) {
                 i++;
             }
 
-			for (uint32_t j = 2 * minDegree; j > i; j--) {
+			for (uint32_t j = 2 * minDegree - 1; j > i; j--) {
 				virtualBPNode[j] = virtualBPNode[j - 1];
 			}
 
@@ -559,228 +726,297 @@ void BPTree<_Tp>::insert(const _Tp key) noexcept {
 			}
 
 			if (curr == root) {
-				BPNode<_Tp>* newRoot = new BPNode<_Tp>(minDegree);
-                newRoot->leaf = false;
+				BPNode<_Tp>* newRoot = allocateNode(false);
 				newRoot->key[0] = newLeaf->key[0];
 				newRoot->child[0] = curr;
 				newRoot->child[1] = newLeaf;
 				newRoot->size = 1;
 				root = newRoot;
+				heightCount++;
 			}
 
 			else {
-				insertInternal(newLeaf->key[0], par, newLeaf);
+				insertInternal(newLeaf->key[0], par, curr, newLeaf);
 			}
-
-            heightCount++;
 		}
 	}
 
     keyCount++;
 }
 
-template <typename _Tp>
-void BPTree<_Tp>::remove(const _Tp key) {
-	if (root == nullptr) {
-        throw std::underflow_error("_BPLUSTREE_ROOT_EMPTY");
+template <typename _Tp, class Cmp, class KT>
+uint64_t BPTree<_Tp, Cmp, KT>::packCount(const uint64_t items, const uint32_t fewest, const uint32_t most, const uint32_t capacity) noexcept {
+    const uint64_t lower = (items + most - 1) / most;
+    const uint64_t upper = items / fewest;
+    const uint64_t target = (items + capacity - 1) / capacity;
+
+    return std::max<uint64_t>(1, std::max(lower, std::min(target, upper)));
+}
+
+template <typename _Tp, class Cmp, class KT>
+template <class Iterator>
+void BPTree<_Tp, Cmp, KT>::packLeaves(Iterator first, const uint64_t begin, const uint64_t end, const uint64_t base, const uint64_t extra,
+    std::vector<BPNode<_Tp>*>& leaves, std::vector<_Tp>& lows) {
+    Iterator it = std::next(first, begin * base + std::min(begin, extra));
+
+    for (uint64_t i = begin; i < end; i++) {
+        BPNode<_Tp>* leaf = BPNode<_Tp>::create(nodePool.allocate_block(), minDegree, true);
+        leaf->size = base + (i < extra);
+
+        for (uint32_t j = 0; j < leaf->size; j++, ++it) {
+            leaf->key[j] = *it;
+        }
+
+        lows[i] = leaf->key[0];
+        leaves[i] = leaf;
     }
+}
 
-	else {
-		BPNode<_Tp>* curr = root;
-		BPNode<_Tp>* par;
-		uint32_t leftSibling, rightSibling;
+template <typename _Tp, class Cmp, class KT>
+template <class Iterator>
+void BPTree<_Tp, Cmp, KT>::bulk_load(Iterator first, Iterator last, const double fill_factor, const uint32_t threads) {
+    if (first != last) {
+        for (Iterator prev = first, curr = std::next(first); curr != last; prev = curr++) {
+            if (lessThan(*curr, *prev)) {
+                throw std::invalid_argument("_BPLUSTREE_UNSORTED_INPUT");
+            }
+        }
+    }
 
-		while (not curr->leaf) {
-			for(uint32_t i = 0; i < curr->size; i++) {
-				par = curr;
-				leftSibling = i - 1;
-				rightSibling =  i + 1;
+    const uint64_t keys = std::distance(first, last);
+    const uint32_t leafCapacity = std::clamp<uint32_t>(fill_factor * (2 * minDegree - 1), minDegree, 2 * minDegree - 1);
+    const uint32_t fanout = std::clamp<uint32_t>(fill_factor * 2 * minDegree, minDegree, 2 * minDegree);
 
-				if (lessThan(key, curr->key[i])) {
-					curr = curr->child[i];
-					break;
-				}
+    clear();
+    keyCount = keys;
+    heightCount = 0;
 
-				if (i == curr->size - 1) {
-					leftSibling = i;
-					rightSibling = i + 2;
-					curr = curr->child[i + 1];
-					break;
-				}
-			}
-		}
+    if (not keys) {
+        return;
+    }
 
-		bool found = false;
-		uint32_t index;
+    uint64_t count = packCount(keys, minDegree, 2 * minDegree - 1, leafCapacity);
+    uint64_t base = keys / count;
+    uint64_t extra = keys % count;
 
-		for(index = 0; index < curr->size; index++) {
-			if(index < curr->size and not (lessThan(curr->key[index], key) or lessThan(key, curr->key[index]))) {
-				found = true;
-				break;
-			}
-		}
+    std::vector<BPNode<_Tp>*> nodes(count);
+    std::vector<_Tp> lows(count);
 
-		if(not found) {
-			if (printKey == nullptr) {
-				throw std::out_of_range("_BPLUSTREE_KEY_NOT_FOUND");
-			}
-			
-            std::stringstream newbuf;
-            std::streambuf* oldbuf = std::cout.rdbuf(newbuf.rdbuf());
-            printKey(key);
-            std::cout.rdbuf(oldbuf);
-            throw std::out_of_range("_BPLUSTREE_KEY_NOT_FOUND: " + newbuf.str());
-        }
+    const uint64_t workers = std::max<uint64_t>(1, std::min<uint64_t>(threads, count));
+    std::vector<std::thread> pool;
 
-		for(uint32_t i = index; i < curr->size; i++) {
-			curr->key[i] = curr->key[i + 1];
-		}
+    for (uint64_t w = 1; w < workers; w++) {
+        pool.emplace_back([&, w] {
+            packLeaves(first, count * w / workers, count * (w + 1) / workers, base, extra, nodes, lows);
+        });
+    }
 
-		curr->size--;
-		if (curr == root) {
-			for (uint32_t i = 0; i < 2 * minDegree; i++) {
-				curr->child[i] = nullptr;
-			}
+    packLeaves(first, 0, count / workers, base, extra, nodes, lows);
+    for (std::thread& worker : pool) {
+        worker.join();
+    }
 
-			if (curr->size == 0) {
-				delete curr;
-				root = nullptr;
-			}
+    for (uint64_t i = 0; i + 1 < count; i++) {
+        nodes[i]->child[nodes[i]->size] = nodes[i + 1];
+    }
 
-            return;
-		}
+    nodeBytes += count * nodePool.block_size();
+
+    while (nodes.size() > 1) {
+        const uint64_t size = nodes.size();
+        count = packCount(size, minDegree, 2 * minDegree, fanout);
+        base = size / count;
+        extra = size % count;
+
+        std::vector<BPNode<_Tp>*> parents(count);
+        std::vector<_Tp> parentLows(count);
 
-		curr->child[curr->size] = curr->child[curr->size + 1];
-		curr->child[curr->size+1] = nullptr;
+        for (uint64_t i = 0, start = 0; i < count; i++) {
+            BPNode<_Tp>* node = allocateNode(false);
+            node->size = base + (i < extra) - 1;
 
-		if (curr->size >= minDegree) {
-            return;
+            for (uint32_t j = 0; j < node->size; j++) {
+                node->key[j] = lows[start + j + 1];
+                node->child[j] = nodes[start + j];
+            }
+
+            node->child[node->size] = nodes[start + node->size];
+            parentLows[i] = lows[start];
+            parents[i] = node;
+            start += node->size + 1;
         }
 
-		if (leftSibling >= 0) {
-			BPNode<_Tp>* leftBPNode = par->child[leftSibling];
-			if(leftBPNode->size >= minDegree + 1) {
-				for(uint32_t i = curr->size; i > 0; i--) {
-					curr->key[i] = curr->key[i - 1];
-				}
+        nodes.swap(parents);
+        lows.swap(parentLows);
+        heightCount++;
+    }
 
-				curr->size++;
-				curr->child[curr->size] = curr->child[curr->size - 1];
-				curr->child[curr->size - 1] = nullptr;
-				curr->key[0] = leftBPNode->key[leftBPNode->size - 1];
+    root = nodes[0];
+}
 
-				leftBPNode->size--;
-				leftBPNode->child[leftBPNode->size] = curr;
-				leftBPNode->child[leftBPNode->size+1] = nullptr;
+template <typename _Tp, class Cmp, class KT>
+void BPTree<_Tp, Cmp, KT>::remove(const _Tp key) {
+	if (root == nullptr) {
+        throw std::underflow_error("_BPLUSTREE_ROOT_EMPTY");
+    }
 
-				par->key[leftSibling] = curr->key[0];
-				return;
-			}
-		}
+    if (not try_remove(key)) {
+        missingKey(key);
+    }
+}
 
-		if (rightSibling <= par->size) {
-			BPNode<_Tp>* rightBPNode = par->child[rightSibling];
-			if(rightBPNode->size >= minDegree + 1) {
-				curr->size++;
-				curr->child[curr->size] = curr->child[curr->size - 1];
-				curr->child[curr->size - 1] = nullptr;
-				curr->key[curr->size - 1] = rightBPNode->key[0];
+template <typename _Tp, class Cmp, class KT>
+bool BPTree<_Tp, Cmp, KT>::try_remove(const _Tp key) noexcept {
+    if (root == nullptr) {
+        return false;
+    }
 
-				rightBPNode->size--;
-				rightBPNode->child[rightBPNode->size] = rightBPNode->child[rightBPNode->size + 1];
-				rightBPNode->child[rightBPNode->size + 1] = nullptr;
+    std::pair<BPNode<_Tp>*, uint32_t> path[_BPLUSTREE_MAX_DEPTH];
+    uint32_t depth = 0;
 
-				for(uint32_t i = 0; i < rightBPNode->size; i++) {
-					rightBPNode->key[i] = rightBPNode->key[i + 1];
-				}
+    BPNode<_Tp>* curr = root;
+    while (not curr->leaf) {
+        uint32_t i = 0;
+        while (i < curr->size and lessThan(curr->key[i], key)) {
+            i++;
+        }
 
-				par->key[rightSibling - 1] = rightBPNode->key[0];
-				return;
-			}
-		}
+        path[depth++] = std::make_pair(curr, i);
+        curr = curr->child[i];
+    }
 
-		if (leftSibling >= 0) {
-			BPNode<_Tp>* leftBPNode = par->child[leftSibling];
-			for(uint32_t i = leftBPNode->size, j = 0; j < curr->size; i++, j++) {
-				leftBPNode->key[i] = curr->key[j];
-			}
+    uint32_t index = 0;
+    while (true) {
+        while (index < curr->size and lessThan(curr->key[index], key)) {
+            index++;
+        }
 
-			leftBPNode->child[leftBPNode->size] = nullptr;
-			leftBPNode->size += curr->size;
-			leftBPNode->child[leftBPNode->size] = curr->child[curr->size];
+        if (index < curr->size) {
+            if (lessThan(key, curr->key[index])) {
+                return false;
+            }
 
-			removeInternal(par->key[leftSibling], par, curr);
-			delete curr;
-		}
+            break;
+        }
 
-		else if (rightSibling <= par->size) {
-			BPNode<_Tp>* rightBPNode = par->child[rightSibling];
-			for (uint32_t i = curr->size, j = 0; j < rightBPNode->size; i++, j++) {
-				curr->key[i] = rightBPNode->key[j];
-			}
+        uint32_t d = depth;
+        while (d > 0 and path[d - 1].second == path[d - 1].first->size) {
+            d--;
+        }
 
-			curr->child[curr->size] = nullptr;
-			curr->size += rightBPNode->size;
-			curr->child[curr->size] = rightBPNode->child[rightBPNode->size];
+        if (d == 0) {
+            return false;
+        }
 
-			removeInternal(par->key[rightSibling - 1], par, rightBPNode);
-			delete rightBPNode;
-		}
-	}
+        path[d - 1].second++;
+        curr = path[d - 1].first->child[path[d - 1].second];
+        for (; d < depth; d++) {
+            path[d] = std::make_pair(curr, 0);
+            curr = curr->child[0];
+        }
+
+        index = 0;
+    }
+
+    for (uint32_t i = index; i + 1 < curr->size; i++) {
+        curr->key[i] = curr->key[i + 1];
+    }
 
+    curr->size--;
+    curr->child[curr->size] = curr->child[curr->size + 1];
+    curr->child[curr->size + 1] = nullptr;
     keyCount--;
+
+    if (curr == root) {
+        if (curr->size == 0) {
+            releaseNode(curr);
+            root = nullptr;
+        }
+
+        return true;
+    }
+
+    if (curr->size >= minDegree) {
+        return true;
+    }
+
+    for (uint32_t d = depth; d > 0; d--) {
+        BPNode<_Tp>* par = path[d - 1].first;
+        if (rebalance(par, path[d - 1].second) == _BPLUSTREE_NOT_MODIFIED or par == root or par->size >= minDegree - 1) {
+            break;
+        }
+    }
+
+    if (not root->leaf and root->size == 0) {
+        BPNode<_Tp>* oldRoot = root;
+        root = root->child[0];
+        releaseNode(oldRoot);
+        heightCount--;
+    }
+
+    return true;
 }
 
-template <typename _Tp>
-std::pair<const BPNode<_Tp>*, uint32_t> BPTree<_Tp>::search(const _Tp key) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+std::pair<const BPNode<_Tp>*, uint32_t> BPTree<_Tp, Cmp, KT>::search(const _Tp key) const noexcept {
 	if(root == nullptr) {
         return std::pair<const BPNode<_Tp>*, uint32_t>(nullptr, 0);
     }
 
 	BPNode<_Tp>* curr = root;
 	while (not curr->leaf) {
-		for (uint32_t i = 0; i < curr->size; i++) {
-			if (key < curr->key[i]) {
-				curr = curr->child[i];
-				break;
-			}
-
-			if (i == curr->size - 1) {
-				curr = curr->child[i + 1];
-				break;
-			}
+		uint32_t i = 0;
+		while (i < curr->size and lessThan(curr->key[i], key)) {
+			i++;
 		}
+
+		curr = curr->child[i];
 	}
 
-	for (uint32_t i = 0; i < curr->size; i++) {
-		if(i < curr->size and not (lessThan(key, curr->key[i]) or lessThan(curr->key[i], key))) {
-			return std::pair<const BPNode<_Tp>*, uint32_t>(curr, i);
+	for (uint32_t i = 0; curr != nullptr; i = 0, curr = curr->child[curr->size]) {
+		while (i < curr->size and lessThan(curr->key[i], key)) {
+			i++;
+		}
+
+		if (i < curr->size) {
+			if (equal(key, curr->key[i])) {
+				return std::pair<const BPNode<_Tp>*, uint32_t>(curr, i);
+			}
+
+			break;
 		}
 	}
 
     return std::pair<const BPNode<_Tp>*, uint32_t>(nullptr, 0);
 }
 
-template <typename _Tp>
-_Tp BPTree<_Tp>::searchKey(const _Tp key) const {
+template <typename _Tp, class Cmp, class KT>
+std::optional<_Tp> BPTree<_Tp, Cmp, KT>::find(const _Tp key) const noexcept {
     std::pair<const BPNode<_Tp>*, uint32_t> node = search(key);
     if (node.first == nullptr) {
-		if (printKey == nullptr) {
-			throw std::out_of_range("_BPLUSTREE_KEY_NOT_FOUND");
-		}
-		
-        std::stringstream newbuf;
-        std::streambuf* oldbuf = std::cout.rdbuf(newbuf.rdbuf());
-        printKey(key);
-        std::cout.rdbuf(oldbuf);
-        throw std::out_of_range("_BPLUSTREE_KEY_NOT_FOUND: " + newbuf.str());
+        return std::nullopt;
     }
 
     return node.first->key[node.second];
 }
 
-template <typename _Tp>
-std::ostream& operator<<(std::ostream& out, const BPTree<_Tp>& bptree) {
+template <typename _Tp, class Cmp, class KT>
+bool BPTree<_Tp, Cmp, KT>::contains(const _Tp key) const noexcept {
+    return search(key).first != nullptr;
+}
+
+template <typename _Tp, class Cmp, class KT>
+_Tp BPTree<_Tp, Cmp, KT>::searchKey(const _Tp key) const {
+    std::optional<_Tp> found = find(key);
+    if (not found) {
+        missingKey(key);
+    }
+
+    return *found;
+}
+
+template <typename _Tp, class Cmp, class KT>
+std::ostream& operator<<(std::ostream& out, const BPTree<_Tp, Cmp, KT>& bptree) {
     if (bptree.printKey != nullptr and bptree.root != nullptr) {
         out << std::endl;
         bptree.printNode(out, bptree.root, 0);
@@ -0,0 +1,252 @@
+#pragma once
+
+#ifndef _NODEPOOL_HPP
+#define _NODEPOOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <memory_resource>
+
+#ifndef _NODEPOOL_SLAB_BYTES
+	#define _NODEPOOL_SLAB_BYTES 65536
+#endif
+
+#ifndef _NODEPOOL_THREAD_CACHES
+	#define _NODEPOOL_THREAD_CACHES 8
+#endif
+
+#ifndef _NODEPOOL_CACHE_LIMIT
+	#define _NODEPOOL_CACHE_LIMIT 64
+#endif
+
+class NodePool : public std::pmr::memory_resource {
+	private:
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		struct ThreadCache {
+			uint64_t owner;
+			FreeBlock* head;
+			uint32_t count;
+		};
+
+		const size_t blockBytes;
+		const size_t alignment;
+		const size_t slabBlocks;
+		std::pmr::memory_resource* upstream;
+
+		std::mutex lock;
+		std::vector<void*> slabs;
+		FreeBlock* freeList;
+		char* cursor;
+		size_t remaining;
+		std::atomic<uint64_t> id;
+
+		static inline std::atomic<uint64_t> nextId{1};
+
+		static ThreadCache& cacheFor(const uint64_t) noexcept;
+
+		FreeBlock* takeShared(void);
+
+		void giveShared(FreeBlock*, FreeBlock*) noexcept;
+
+		void refill(ThreadCache&);
+
+		void flush(ThreadCache&, const uint32_t) noexcept;
+
+	protected:
+		void* do_allocate(size_t, size_t) override;
+
+		void do_deallocate(void*, size_t, size_t) override;
+
+		bool do_is_equal(const std::pmr::memory_resource&) const noexcept override;
+
+	public:
+		explicit NodePool(const size_t, const size_t = 64, std::pmr::memory_resource* = std::pmr::get_default_resource());
+
+		NodePool(const NodePool&) = delete;
+
+		NodePool& operator=(const NodePool&) = delete;
+
+		~NodePool(void);
+
+		void* allocate_block(void);
+
+		void release_block(void*) noexcept;
+
+		void release_all(void) noexcept;
+
+		size_t block_size(void) const noexcept;
+
+		size_t num_slabs(void) const noexcept;
+
+		std::pmr::memory_resource* upstream_resource(void) const noexcept;
+};
+
+inline NodePool::NodePool(const size_t bytes, const size_t align, std::pmr::memory_resource* resource)
+	: blockBytes((std::max(bytes, sizeof(FreeBlock)) + align - 1) / align * align), alignment(align),
+	slabBlocks(std::max<size_t>(16, _NODEPOOL_SLAB_BYTES / ((std::max(bytes, sizeof(FreeBlock)) + align - 1) / align * align))),
+	upstream(resource), freeList(nullptr), cursor(nullptr), remaining(0), id(nextId++) {}
+
+inline NodePool::~NodePool(void) {
+	release_all();
+}
+
+inline NodePool::ThreadCache& NodePool::cacheFor(const uint64_t owner) noexcept {
+	thread_local ThreadCache caches[_NODEPOOL_THREAD_CACHES] = {};
+	return caches[owner % _NODEPOOL_THREAD_CACHES];
+}
+
+inline NodePool::FreeBlock* NodePool::takeShared(void) {
+	if (freeList) {
+		FreeBlock* block = freeList;
+		freeList = block->next;
+		return block;
+	}
+
+	if (not remaining) {
+		cursor = (char*) upstream->allocate(slabBlocks * blockBytes, alignment);
+		slabs.push_back(cursor);
+		remaining = slabBlocks;
+	}
+
+	FreeBlock* block = (FreeBlock*) cursor;
+	cursor += blockBytes;
+	remaining--;
+	return block;
+}
+
+inline void NodePool::giveShared(FreeBlock* first, FreeBlock* last) noexcept {
+	last->next = freeList;
+	freeList = first;
+}
+
+inline void NodePool::refill(ThreadCache& cache) {
+	std::lock_guard<std::mutex> guard(lock);
+
+	for (uint32_t i = 0; i < _NODEPOOL_CACHE_LIMIT / 2; i++) {
+		FreeBlock* block = takeShared();
+		block->next = cache.head;
+		cache.head = block;
+		cache.count++;
+	}
+}
+
+inline void NodePool::flush(ThreadCache& cache, const uint32_t keep) noexcept {
+	if (cache.count <= keep) {
+		return;
+	}
+
+	FreeBlock* first = cache.head;
+	FreeBlock* last = first;
+	for (uint32_t i = cache.count - keep; i > 1; i--) {
+		last = last->next;
+	}
+
+	cache.head = last->next;
+	cache.count = keep;
+
+	std::lock_guard<std::mutex> guard(lock);
+	giveShared(first, last);
+}
+
+inline void* NodePool::allocate_block(void) {
+	const uint64_t owner = id.load(std::memory_order_relaxed);
+	ThreadCache& cache = cacheFor(owner);
+
+	if (cache.owner != owner and cache.count) {
+		std::lock_guard<std::mutex> guard(lock);
+		return takeShared();
+	}
+
+	cache.owner = owner;
+	if (not cache.count) {
+		refill(cache);
+	}
+
+	FreeBlock* block = cache.head;
+	cache.head = block->next;
+	cache.count--;
+	return block;
+}
+
+inline void NodePool::release_block(void* ptr) noexcept {
+	const uint64_t owner = id.load(std::memory_order_relaxed);
+	ThreadCache& cache = cacheFor(owner);
+	FreeBlock* block = (FreeBlock*) ptr;
+
+	if (cache.owner != owner and cache.count) {
+		std::lock_guard<std::mutex> guard(lock);
+		giveShared(block, block);
+		return;
+	}
+
+	cache.owner = owner;
+	block->next = cache.head;
+	cache.head = block;
+	cache.count++;
+
+	if (cache.count > _NODEPOOL_CACHE_LIMIT) {
+		flush(cache, _NODEPOOL_CACHE_LIMIT / 2);
+	}
+}
+
+inline void NodePool::release_all(void) noexcept {
+	ThreadCache& cache = cacheFor(id.load(std::memory_order_relaxed));
+	if (cache.owner == id.load(std::memory_order_relaxed)) {
+		cache.head = nullptr;
+		cache.count = 0;
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+	for (void* slab : slabs) {
+		upstream->deallocate(slab, slabBlocks * blockBytes, alignment);
+	}
+
+	slabs.clear();
+	freeList = nullptr;
+	cursor = nullptr;
+	remaining = 0;
+	id = nextId++;
+}
+
+inline void* NodePool::do_allocate(size_t bytes, size_t align) {
+	if (bytes <= blockBytes and align <= alignment) {
+		return allocate_block();
+	}
+
+	return upstream->allocate(bytes, align);
+}
+
+inline void NodePool::do_deallocate(void* ptr, size_t bytes, size_t align) {
+	if (bytes <= blockBytes and align <= alignment) {
+		release_block(ptr);
+	}
+
+	else {
+		upstream->deallocate(ptr, bytes, align);
+	}
+}
+
+inline bool NodePool::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+	return this == &other;
+}
+
+inline size_t NodePool::block_size(void) const noexcept {
+	return blockBytes;
+}
+
+inline size_t NodePool::num_slabs(void) const noexcept {
+	return slabs.size();
+}
+
+inline std::pmr::memory_resource* NodePool::upstream_resource(void) const noexcept {
+	return upstream;
+}
+
+#endif
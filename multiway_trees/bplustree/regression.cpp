@@ -0,0 +1,257 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <set>
+#include "bplustree.hpp"
+using namespace std;
+
+void test_single_leaf(void) {
+    BPTree<int> tree(2);
+    for (int i = 3; i > 0; i--) {
+        tree.insert(i);
+    }
+
+    assert(tree.num_keys() == 3);
+    for (int i = 1; i <= 3; i++) {
+        assert(tree.searchKey(i) == i);
+    }
+
+    assert(tree.search(4).first == nullptr);
+}
+
+void test_leaf_split(void) {
+    BPTree<int> ascending(2);
+    BPTree<int> descending(2);
+    for (int i = 1; i <= 8; i++) {
+        ascending.insert(i);
+        descending.insert(9 - i);
+    }
+
+    for (int i = 1; i <= 8; i++) {
+        assert(ascending.searchKey(i) == i);
+        assert(descending.searchKey(i) == i);
+    }
+
+    assert(ascending.search(0).first == nullptr);
+    assert(descending.search(9).first == nullptr);
+}
+
+void test_internal_split(void) {
+    vector<int> keys(5000);
+    for (int i = 0; i < 5000; i++) {
+        keys[i] = 2 * i;
+    }
+
+    mt19937 gen(1);
+    shuffle(keys.begin(), keys.end(), gen);
+
+    for (uint32_t deg : {2, 3, 16}) {
+        BPTree<int> tree(deg);
+        for (int k : keys) {
+            tree.insert(k);
+        }
+
+        assert(tree.num_keys() == keys.size());
+        for (int k : keys) {
+            assert(tree.searchKey(k) == k);
+            assert(tree.search(k + 1).first == nullptr);
+        }
+    }
+}
+
+void test_deep_ascending(void) {
+    BPTree<int> tree(2);
+    for (int i = 0; i < 20000; i++) {
+        tree.insert(i);
+    }
+
+    for (int i = 0; i < 20000; i++) {
+        assert(tree.searchKey(i) == i);
+    }
+
+    assert(tree.search(20000).first == nullptr);
+}
+
+void test_height(void) {
+    BPTree<int> tree(2);
+    for (int i = 1; i <= 3; i++) {
+        tree.insert(i);
+    }
+
+    assert(tree.height() == 0);
+
+    for (int i = 4; i <= 8; i++) {
+        tree.insert(i);
+    }
+
+    assert(tree.height() == 1);
+
+    for (int i = 9; i <= 10; i++) {
+        tree.insert(i);
+    }
+
+    assert(tree.height() == 2);
+}
+
+void test_empty_tree(void) {
+    BPTree<int> tree(2);
+    assert(tree.search(1).first == nullptr);
+
+    BPTree<int> copy(tree);
+    assert(copy.num_keys() == 0);
+    assert(copy.search(1).first == nullptr);
+}
+
+void test_copy(void) {
+    BPTree<int> tree(2);
+    for (int i = 0; i < 1000; i++) {
+        tree.insert(i);
+    }
+
+    BPTree<int> copy(tree);
+    BPTree<int> assigned(2);
+    assigned.insert(-1);
+    assigned = tree;
+    assigned = assigned;
+
+    for (int i = 0; i < 1000; i++) {
+        assert(copy.searchKey(i) == i);
+        assert(assigned.searchKey(i) == i);
+    }
+
+    assert(assigned.search(-1).first == nullptr);
+    assert(copy.num_keys() == 1000 and assigned.num_keys() == 1000);
+}
+
+void test_merge_into_root(void) {
+    BPTree<int> tree(2);
+    for (int i = 1; i <= 4; i++) {
+        tree.insert(i);
+    }
+
+    tree.remove(4);
+    for (int i = 1; i <= 3; i++) {
+        assert(tree.searchKey(i) == i);
+    }
+
+    assert(tree.search(4).first == nullptr);
+    assert(tree.num_keys() == 3);
+    assert(tree.height() == 0);
+}
+
+void test_random_remove(void) {
+    vector<int> keys(3000);
+    for (int i = 0; i < 3000; i++) {
+        keys[i] = i;
+    }
+
+    mt19937 gen(3);
+    for (uint32_t deg : {2, 3, 4, 16}) {
+        shuffle(keys.begin(), keys.end(), gen);
+        BPTree<int> tree(deg);
+        for (int k : keys) {
+            tree.insert(k);
+        }
+
+        shuffle(keys.begin(), keys.end(), gen);
+        for (uint32_t i = 0; i < keys.size() / 2; i++) {
+            tree.remove(keys[i]);
+        }
+
+        assert(tree.num_keys() == keys.size() - keys.size() / 2);
+        for (uint32_t i = 0; i < keys.size(); i++) {
+            assert((tree.search(keys[i]).first != nullptr) == (i >= keys.size() / 2));
+        }
+
+        for (uint32_t i = keys.size() / 2; i < keys.size(); i++) {
+            tree.remove(keys[i]);
+        }
+
+        assert(tree.num_keys() == 0 and tree.height() == 0);
+        assert(tree.search(keys[0]).first == nullptr);
+
+        bool thrown = false;
+        try {
+            tree.remove(keys[0]);
+        }
+
+        catch (const underflow_error&) {
+            thrown = true;
+        }
+
+        assert(thrown);
+    }
+}
+
+void test_duplicate_keys(void) {
+    for (uint32_t deg : {2, 3, 4}) {
+        mt19937 gen(1);
+        BPTree<int> tree(deg);
+        multiset<int> oracle;
+
+        for (int step = 0; step < 4000; step++) {
+            int k = gen() % 400;
+            if (oracle.empty() or gen() % 3) {
+                tree.insert(k);
+                oracle.insert(k);
+            }
+
+            else {
+                assert(tree.try_remove(k) == (oracle.count(k) > 0));
+                if (oracle.count(k)) {
+                    oracle.erase(oracle.find(k));
+                }
+            }
+
+            if (step % 100 == 0) {
+                for (int q = 0; q < 400; q++) {
+                    assert(tree.contains(q) == (oracle.count(q) > 0));
+                }
+            }
+        }
+
+        assert(tree.num_keys() == oracle.size());
+        for (int k : oracle) {
+            assert(tree.contains(k));
+            assert(tree.try_remove(k));
+        }
+
+        assert(tree.num_keys() == 0 and not tree.contains(0));
+    }
+}
+
+bool greater_than(const int& a, const int& b) {
+    return a > b;
+}
+
+void test_pointer_comparator(void) {
+    BPTree tree(2, greater_than);
+    for (int i = 0; i < 100; i++) {
+        tree.insert(i);
+    }
+
+    for (int i = 0; i < 100; i++) {
+        assert(tree.searchKey(i) == i);
+    }
+
+    assert(not tree.contains(100));
+}
+
+int main(void) {
+    test_single_leaf();
+    test_leaf_split();
+    test_internal_split();
+    test_deep_ascending();
+    test_height();
+    test_empty_tree();
+    test_copy();
+    test_merge_into_root();
+    test_random_remove();
+    test_duplicate_keys();
+    test_pointer_comparator();
+
+    cout << "bplustree regression tests passed\n";
+    return 0;
+}
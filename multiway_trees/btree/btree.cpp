@@ -3,9 +3,465 @@
 #include <string>
 #include <chrono>
 #include <fstream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <shared_mutex>
 #include "btree.hpp"
+#include "concurrentbtree.hpp"
 using namespace std;
 
+template <class Tree>
+void report_comparator(Tree& tree, const char* name, const vector<int>& keys) {
+	using namespace std::chrono;
+
+	steady_clock::time_point start = steady_clock::now();
+	for (int key : keys) {
+		tree.insert(key);
+	}
+	double insert_time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+	uint64_t found = 0;
+	start = steady_clock::now();
+	for (int key : keys) {
+		found += tree.search(key).first != nullptr;
+	}
+	double search_time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+	std::cout << name << "\t" << insert_time << " ns\t\t" << search_time << " ns\t\t" << found << "\n";
+}
+
+bool compare(const int& a, const int& b);
+
+void benchmark_comparator(const uint32_t deg) {
+	vector<int> keys;
+	for (int i = -50000; i < 50000; i++) {
+		keys.push_back(i + 1);
+	}
+	shuffle(keys.begin(), keys.end(), mt19937(42));
+
+	BTree pointer_tree(deg, compare);
+	BTree<int> inlined_tree(deg);
+
+	std::cout << "\ncomparator\t\tinsert\t\tsearch\t\tfound\n";
+	report_comparator(pointer_tree, "function pointer", keys);
+	report_comparator(inlined_tree, "std::less\t", keys);
+}
+
+template <uint8_t Strategy>
+struct SearchTraits {
+	static constexpr bool fixed_width = true;
+	static constexpr uint32_t width = sizeof(int);
+	static constexpr uint8_t search = Strategy;
+};
+
+template <uint8_t Strategy>
+double time_node_search(const uint32_t deg, const vector<int>& keys) {
+	using namespace std::chrono;
+
+	BTree<int, less<int>, SearchTraits<Strategy>> tree(deg);
+	for (int key : keys) {
+		tree.insert(key);
+	}
+
+	uint64_t found = 0;
+	steady_clock::time_point start = steady_clock::now();
+	for (int key : keys) {
+		found += tree.search(key).first != nullptr;
+		found += tree.search(key + 1).first != nullptr;
+	}
+	double elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (2.0 * keys.size());
+
+	return found == keys.size() ? elapsed : -1;
+}
+
+void benchmark_node_search(void) {
+	vector<int> keys;
+	for (int i = 0; i < 100000; i++) {
+		keys.push_back(2 * i);
+	}
+	shuffle(keys.begin(), keys.end(), mt19937(7));
+
+	std::cout << "\ndegree\tlinear\t\tbinary\t\tsimd\t\t(search ns, hits and misses)\n";
+	for (uint32_t deg = 4; deg <= 256; deg *= 2) {
+		std::cout << deg << "\t" << time_node_search<_BTREE_SEARCH_LINEAR>(deg, keys) << " ns\t";
+		std::cout << time_node_search<_BTREE_SEARCH_BINARY>(deg, keys) << " ns\t";
+		std::cout << time_node_search<_BTREE_SEARCH_SIMD>(deg, keys) << " ns\n";
+	}
+}
+
+void report_allocator(const uint32_t deg, const char* name, std::pmr::memory_resource* upstream, const vector<int>& keys) {
+	using namespace std::chrono;
+
+	BTree<int>* tree = new BTree<int>(deg, less<int>(), nullptr, upstream);
+
+	steady_clock::time_point start = steady_clock::now();
+	for (int key : keys) {
+		tree->insert(key);
+	}
+	double insert_time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+	uint64_t memory = tree->memory_in_bytes();
+
+	start = steady_clock::now();
+	delete tree;
+	double teardown_time = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+	std::cout << name << "\t" << insert_time << " ns\t\t" << teardown_time << " ms\t\t" << memory << "\n";
+}
+
+void benchmark_allocator(const uint32_t deg) {
+	vector<int> keys;
+	for (int i = 0; i < 1000000; i++) {
+		keys.push_back(i);
+	}
+	shuffle(keys.begin(), keys.end(), mt19937(11));
+
+	std::pmr::unsynchronized_pool_resource pool_resource;
+	std::pmr::monotonic_buffer_resource arena_resource;
+
+	std::cout << "\nupstream\t\tinsert\t\tteardown\tnode memory (bytes)\n";
+	report_allocator(deg, "new / delete\t", std::pmr::new_delete_resource(), keys);
+	report_allocator(deg, "unsynchronized pool", &pool_resource, keys);
+	report_allocator(deg, "monotonic arena\t", &arena_resource, keys);
+}
+
+template <class Load>
+void report_bulk_load(const uint32_t deg, const char* name, Load load) {
+	using namespace std::chrono;
+
+	BTree<int> tree(deg);
+
+	steady_clock::time_point start = steady_clock::now();
+	load(tree);
+	double time = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+	std::cout << name << "\t" << time << " ms\t\t" << tree.height() << "\t" << tree.memory_in_bytes() << "\n";
+}
+
+void benchmark_bulk_load(const uint32_t deg) {
+	vector<int> keys;
+	for (int i = 0; i < 1000000; i++) {
+		keys.push_back(i);
+	}
+
+	const uint32_t threads = max(1u, thread::hardware_concurrency());
+
+	std::cout << "\nloading\t\t\ttime\t\theight\tnode memory (bytes)\n";
+	report_bulk_load(deg, "repeated insert\t", [&](BTree<int>& tree) {
+		for (int key : keys) {
+			tree.insert(key);
+		}
+	});
+	report_bulk_load(deg, "bulk load\t", [&](BTree<int>& tree) {
+		tree.bulk_load(keys.begin(), keys.end());
+	});
+	report_bulk_load(deg, "bulk load (70% fill)", [&](BTree<int>& tree) {
+		tree.bulk_load(keys.begin(), keys.end(), 0.7);
+	});
+	report_bulk_load(deg, "parallel bulk load", [&](BTree<int>& tree) {
+		tree.bulk_load(keys.begin(), keys.end(), 1.0, threads);
+	});
+}
+
+template <class Visit>
+void report_range_scan(const char* name, const vector<pair<int, int>>& ranges, Visit visit) {
+	using namespace std::chrono;
+
+	uint64_t visited = 0, sum = 0;
+	steady_clock::time_point start = steady_clock::now();
+	for (const pair<int, int>& range : ranges) {
+		visited += visit(range.first, range.second, sum);
+	}
+	double time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) visited;
+
+	std::cout << name << "\t" << time << " ns\t\t" << visited << "\t" << sum << "\n";
+}
+
+void benchmark_range_scan(const uint32_t deg) {
+	vector<int> keys;
+	for (int i = 0; i < 1000000; i++) {
+		keys.push_back(2 * i);
+	}
+	shuffle(keys.begin(), keys.end(), mt19937(5));
+
+	BTree<int> tree(deg);
+	for (int key : keys) {
+		tree.insert(key);
+	}
+
+	mt19937 prng(9);
+	vector<pair<int, int>> ranges;
+	for (int i = 0; i < 1000; i++) {
+		int lo = prng() % 2000000;
+		ranges.push_back(make_pair(lo, lo + 2000));
+	}
+
+	std::cout << "\nrange walk\t\tper key\t\tvisited\tchecksum\n";
+	report_range_scan("point searches\t", ranges, [&](int lo, int hi, uint64_t& sum) {
+		uint64_t count = 0;
+		for (int key = lo; key <= hi; key++) {
+			pair<const BNode<int>*, uint32_t> node = tree.search(key);
+			if (node.first != nullptr) {
+				sum += key;
+				count++;
+			}
+		}
+		return count;
+	});
+	report_range_scan("iterators\t", ranges, [&](int lo, int hi, uint64_t& sum) {
+		uint64_t count = 0;
+		for (BTree<int>::iterator it = tree.lower_bound(lo), last = tree.upper_bound(hi); it != last; ++it) {
+			sum += *it;
+			count++;
+		}
+		return count;
+	});
+	report_range_scan("scan\t\t", ranges, [&](int lo, int hi, uint64_t& sum) {
+		return tree.scan(lo, hi, [&](const int& key) {
+			sum += key;
+		});
+	});
+}
+
+void print(const int& x);
+
+template <class Lookup>
+void report_missing(const char* name, const vector<int>& probes, Lookup lookup) {
+	using namespace std::chrono;
+
+	uint64_t found = 0;
+	steady_clock::time_point start = steady_clock::now();
+	for (int probe : probes) {
+		found += lookup(probe);
+	}
+	double time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) probes.size();
+
+	std::cout << name << "\t" << time << " ns\t\t" << found << "\n";
+}
+
+void benchmark_missing(const uint32_t deg) {
+	BTree<int> tree(deg, less<int>(), print);
+	for (int i = 0; i < 100000; i++) {
+		tree.insert(2 * i);
+	}
+
+	mt19937 prng(13);
+	vector<int> probes;
+	for (int i = 0; i < 1000000; i++) {
+		int key = prng() % 200000;
+		probes.push_back(prng() % 10 ? key bitor 1 : key & ~1);
+	}
+
+	std::cout << "\nlookup (90% misses)\tper probe\tfound\n";
+	report_missing("searchKey + catch", probes, [&](int key) {
+		try {
+			tree.searchKey(key);
+			return true;
+		}
+		catch (const out_of_range& exc) {
+			return false;
+		}
+	});
+	report_missing("find\t\t", probes, [&](int key) {
+		return tree.find(key).has_value();
+	});
+	report_missing("contains\t", probes, [&](int key) {
+		return tree.contains(key);
+	});
+
+	vector<int> misses(probes.begin(), probes.begin() + 100000);
+	for (int& key : misses) {
+		key = key bitor 1;
+	}
+
+	report_missing("remove + catch\t", misses, [&](int key) {
+		try {
+			tree.remove(key);
+			return true;
+		}
+		catch (const out_of_range& exc) {
+			return false;
+		}
+	});
+	report_missing("try_remove\t", misses, [&](int key) {
+		return bool(tree.try_remove(key));
+	});
+}
+
+template <class Take>
+void report_snapshot(const uint32_t deg, const char* name, const vector<int>& keys, const vector<int>& updates, Take take) {
+	using namespace std::chrono;
+
+	BTree<int> tree(deg);
+	tree.bulk_load(keys.begin(), keys.end());
+
+	steady_clock::time_point start = steady_clock::now();
+	BTree<int> view = take(tree);
+	double take_time = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+	start = steady_clock::now();
+	for (int key : updates) {
+		tree.insert(key);
+	}
+	double insert_time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) updates.size();
+
+	std::cout << name << "\t" << take_time << " ms\t\t" << insert_time << " ns\t\t" << view.num_keys() << "\t" << tree.num_keys() << "\n";
+}
+
+void benchmark_snapshot(const uint32_t deg) {
+	vector<int> keys;
+	for (int i = 0; i < 1000000; i++) {
+		keys.push_back(2 * i);
+	}
+
+	mt19937 prng(21);
+	vector<int> updates;
+	for (int i = 0; i < 100000; i++) {
+		updates.push_back(2 * (prng() % 1000000) + 1);
+	}
+
+	std::cout << "\nview\t\ttake\t\tinsert after\tview keys\ttree keys\n";
+	report_snapshot(deg, "deep copy", keys, updates, [](const BTree<int>& tree) {
+		return BTree<int>(tree);
+	});
+	report_snapshot(deg, "snapshot", keys, updates, [](const BTree<int>& tree) {
+		return tree.snapshot();
+	});
+}
+
+void benchmark_frozen(const uint32_t deg) {
+	using namespace std::chrono;
+
+	vector<int> keys;
+	for (int i = 0; i < 1000000; i++) {
+		keys.push_back(2 * i);
+	}
+
+	BTree<int> tree(deg);
+	tree.bulk_load(keys.begin(), keys.end());
+
+	steady_clock::time_point start = steady_clock::now();
+	FrozenBTree<int> frozen = tree.freeze();
+	double freeze_time = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+	mt19937 prng(23);
+	vector<int> probes;
+	for (int i = 0; i < 1000000; i++) {
+		probes.push_back(prng() % 2000000);
+	}
+
+	std::cout << "\nfrozen layout: " << freeze_time << " ms to freeze, height " << frozen.height() << ", " << frozen.memory_in_bytes() << " bytes (tree nodes: " << tree.memory_in_bytes() << ")\n";
+	std::cout << "lookup (50% hits)\tper probe\tfound\n";
+	report_missing("btree contains", probes, [&](int key) {
+		return tree.contains(key);
+	});
+	report_missing("frozen contains", probes, [&](int key) {
+		return frozen.contains(key);
+	});
+
+	bool* hits = new bool[probes.size()];
+	start = steady_clock::now();
+	uint64_t found = frozen.contains_batch(probes.data(), probes.size(), hits);
+	double batch_time = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) probes.size();
+	delete[] hits;
+
+	std::cout << "frozen batch\t\t" << batch_time << " ns\t\t" << found << "\n";
+}
+
+class LockedBTree {
+	private:
+		BTree<int> tree;
+		mutable shared_mutex lock;
+
+	public:
+		explicit LockedBTree(const uint32_t deg) : tree(deg) {}
+
+		void insert(const int key) {
+			unique_lock<shared_mutex> guard(lock);
+			tree.insert(key);
+		}
+
+		optional<int> try_remove(const int key) {
+			unique_lock<shared_mutex> guard(lock);
+			return tree.try_remove(key);
+		}
+
+		bool contains(const int key) const {
+			shared_lock<shared_mutex> guard(lock);
+			return tree.contains(key);
+		}
+};
+
+template <class Tree>
+void report_concurrent(const char* name, const unsigned n_threads, Tree& tree, const vector<int>& keys) {
+	using namespace std::chrono;
+
+	const size_t half = keys.size() / 2;
+	for (size_t i = 0; i < half; i++) {
+		tree.insert(keys[i]);
+	}
+
+	atomic<bool> running(true);
+	atomic<uint64_t> lookups(0), found(0);
+	uint64_t updates = 0;
+
+	vector<thread> readers;
+	for (unsigned t = 0; t < n_threads; t++) {
+		readers.emplace_back([&, t]() {
+			uint64_t count = 0, hits = 0;
+			for (size_t i = t; running.load(std::memory_order_relaxed); i = (i + 1) % keys.size()) {
+				hits += tree.contains(keys[i]);
+				count++;
+			}
+			lookups.fetch_add(count);
+			found.fetch_add(hits);
+		});
+	}
+
+	thread writer([&]() {
+		for (size_t i = 0; running.load(std::memory_order_relaxed); i = (i + 1) % half) {
+			tree.try_remove(keys[i]);
+			tree.insert(keys[i + half]);
+			tree.try_remove(keys[i + half]);
+			tree.insert(keys[i]);
+			updates += 4;
+		}
+	});
+
+	steady_clock::time_point start = steady_clock::now();
+	this_thread::sleep_for(milliseconds(500));
+	running.store(false);
+
+	for (thread& reader : readers) {
+		reader.join();
+	}
+	writer.join();
+
+	double secs = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e9;
+	std::cout << name << "\t" << n_threads << "\t" << lookups.load() / secs << "\t\t" << updates / secs << "\t\t" << found.load() << "\n";
+}
+
+void benchmark_concurrent(const uint32_t deg) {
+	vector<int> keys;
+	for (int i = 0; i < 1000000; i++) {
+		keys.push_back(i);
+	}
+	shuffle(keys.begin(), keys.end(), mt19937(17));
+
+	const unsigned max_threads = max(1u, thread::hardware_concurrency());
+
+	std::cout << "\ntree\t\tthreads\tlookups/sec\t\tupdates/sec\t\tfound\n";
+	for (unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+		LockedBTree locked(deg);
+		report_concurrent("shared mutex", n_threads, locked, keys);
+
+		ConcurrentBTree<int> optimistic(deg);
+		report_concurrent("optimistic\t", n_threads, optimistic, keys);
+	}
+}
+
 void benchmark(BTree<int>& tree) {
 	using namespace std::chrono;
 
@@ -25,6 +481,7 @@ void benchmark(BTree<int>& tree) {
 	std::cout << "\nnumber of keys: " << tree.num_keys();
     std::cout << "\nsize of tree (bytes): " << tree.size_in_bytes();
     std::cout << "\naverage size per key (bytes): " << (double)tree.size_in_bytes() / tree.num_keys();
+    std::cout << "\nnode memory (bytes): " << tree.memory_in_bytes() << " (" << (double)tree.memory_in_bytes() / tree.num_keys() << " per key)";
     std::cout << "\naverage key insertion time: " << time << " ns\n";
 
 	int input;
@@ -64,7 +521,17 @@ int main(void) {
 		cout << "minimum degree of btree: ";
 		cin >> deg;
 
-        BTree<int> tree(deg, compare, print);
+        benchmark_comparator(deg);
+        benchmark_node_search();
+        benchmark_allocator(deg);
+        benchmark_bulk_load(deg);
+        benchmark_range_scan(deg);
+        benchmark_missing(deg);
+        benchmark_concurrent(deg);
+        benchmark_snapshot(deg);
+        benchmark_frozen(deg);
+
+        BTree<int> tree(deg, less<int>(), print);
         benchmark(tree);
         return 0;
     }
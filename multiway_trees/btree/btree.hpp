@@ -1,7 +1,26 @@
 #pragma once
 
+#include <cstdint>
+#include <cstddef>
 #include <utility>
 #include <sstream>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <new>
+#include <memory>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "nodepool.hpp"
+#include "frozenbtree.hpp"
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#endif
 
 #ifndef _BTREE_NOT_MODIFIED
 	#define _BTREE_NOT_MODIFIED 0
@@ -15,15 +34,55 @@
 	#define _BTREE_NEW_ROOT 2
 #endif
 
-typedef unsigned char uint8_t;
-typedef unsigned short uint16_t;
-typedef unsigned int uint32_t;
-typedef unsigned long long uint64_t;
-typedef unsigned int size_t;
+#ifndef _BTREE_NODE_ALIGNMENT
+	#define _BTREE_NODE_ALIGNMENT 64
+#endif
+
+#ifndef _BTREE_SEARCH_LINEAR
+	#define _BTREE_SEARCH_LINEAR 0
+#endif
 
-template <typename _Tp> class BTree;
+#ifndef _BTREE_SEARCH_BINARY
+	#define _BTREE_SEARCH_BINARY 1
+#endif
+
+#ifndef _BTREE_SEARCH_SIMD
+	#define _BTREE_SEARCH_SIMD 2
+#endif
 
-template <typename _Tp> std::ostream& operator<<(std::ostream&, const BTree<_Tp>&);
+#ifndef _BTREE_MAX_DEPTH
+	#define _BTREE_MAX_DEPTH 32
+#endif
+
+template <typename _Tp, typename = void>
+struct BTreeKeyTraits {
+	static constexpr bool fixed_width = false;
+	static constexpr uint8_t search = _BTREE_SEARCH_BINARY;
+};
+
+template <typename _Tp>
+struct BTreeKeyTraits<_Tp, typename std::enable_if<std::is_integral<_Tp>::value>::type> {
+	static constexpr bool fixed_width = true;
+	static constexpr uint32_t width = sizeof(_Tp);
+	static constexpr uint8_t search = _BTREE_SEARCH_BINARY;
+};
+
+template <typename _Tp>
+class BTreeLessThan {
+	private:
+		bool (*lessThan)(const _Tp&, const _Tp&);
+
+	public:
+		BTreeLessThan(bool (*compare)(const _Tp&, const _Tp&)) : lessThan(compare) {}
+
+		bool operator()(const _Tp& a, const _Tp& b) const {
+			return lessThan(a, b);
+		}
+};
+
+template <typename _Tp, class Compare = std::less<_Tp>, class KeyTraits = BTreeKeyTraits<_Tp>> class BTree;
+
+template <typename _Tp, class Cmp, class KT> std::ostream& operator<<(std::ostream&, const BTree<_Tp, Cmp, KT>&);
 
 template <typename _Tp>
 class BNode {
@@ -31,36 +90,123 @@ class BNode {
 		BNode** child;
 		_Tp* key;
 		uint32_t size;
+		std::atomic<uint32_t> refs;
 		bool leaf;
 
-		friend class BTree<_Tp>;
+		template <typename, class, class> friend class BTree;
+		template <typename> friend class BTreeIterator;
+
+		static constexpr uint64_t keyOffset(void) noexcept;
+
+		static uint64_t childOffset(const uint32_t) noexcept;
 
-		void deepClean(void) noexcept;
+		BNode(const uint32_t, const bool) noexcept;
+
+		~BNode(void) = default;
 
 	public:
-		explicit BNode(const uint32_t);
+		static uint64_t blockSize(const uint32_t, const bool) noexcept;
+
+		static BNode* create(void*, const uint32_t, const bool) noexcept;
 
-		~BNode(void);
+		static void destroy(BNode*, const uint32_t) noexcept;
 };
 
 template <typename _Tp>
+class BTreeIterator {
+	private:
+		std::pair<const BNode<_Tp>*, uint32_t> path[_BTREE_MAX_DEPTH];
+		uint32_t depth;
+		const BNode<_Tp>* root;
+
+		template <typename, class, class> friend class BTree;
+
+		explicit BTreeIterator(const BNode<_Tp>*) noexcept;
+
+		void pushLeftmost(const BNode<_Tp>*) noexcept;
+
+		void pushRightmost(const BNode<_Tp>*) noexcept;
+
+		void ascendForward(void) noexcept;
+
+		void ascendBackward(void) noexcept;
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = _Tp;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const _Tp*;
+		using reference = const _Tp&;
+
+		BTreeIterator(void) noexcept;
+
+		reference operator*(void) const noexcept;
+
+		pointer operator->(void) const noexcept;
+
+		BTreeIterator& operator++(void) noexcept;
+
+		BTreeIterator operator++(int) noexcept;
+
+		BTreeIterator& operator--(void) noexcept;
+
+		BTreeIterator operator--(int) noexcept;
+
+		bool operator==(const BTreeIterator&) const noexcept;
+
+		bool operator!=(const BTreeIterator&) const noexcept;
+};
+
+template <typename _Tp, class Compare, class KeyTraits>
 class BTree {
 	private:
 		BNode<_Tp>* root;
 		const uint32_t minDegree;
 
-		bool (*lessThan)(const _Tp&, const _Tp&) noexcept;
-		void (*printKey)(const _Tp&) noexcept;
+		Compare lessThan;
+		void (*printKey)(const _Tp&);
+
+		struct NodeStore {
+			NodePool leafPool;
+			NodePool internalPool;
+			std::atomic<uint64_t> nodeBytes;
+
+			NodeStore(const uint32_t, std::pmr::memory_resource*);
+		};
 
 		uint32_t keyCount;
 		uint32_t heightCount;
 
+		std::shared_ptr<NodeStore> store;
+
+		BTree(const BTree&, const std::shared_ptr<NodeStore>&) noexcept;
+
+		BNode<_Tp>* allocateNode(const bool);
+
+		void releaseNode(BNode<_Tp>*) noexcept;
+
+		void dropNode(BNode<_Tp>*) noexcept;
+
+		BNode<_Tp>* writable(BNode<_Tp>*&);
+
+		bool equal(const _Tp&, const _Tp&) const noexcept;
+
 		void copyNode(BNode<_Tp>*&, const BNode<_Tp>*) noexcept;
 
 		void freeNode(BNode<_Tp>*);
 
+		void clear(void) noexcept;
+
 		uint32_t findIndex(const BNode<_Tp>*, const _Tp) const noexcept;
 
+		uint32_t upperIndex(const BNode<_Tp>*, const _Tp&) const noexcept;
+
+		uint32_t linearIndex(const _Tp*, const uint32_t, const _Tp&) const noexcept;
+
+		uint32_t binaryIndex(const _Tp*, const uint32_t, const _Tp&) const noexcept;
+
+		static uint32_t simdIndex(const _Tp*, const uint32_t, const _Tp&) noexcept;
+
 		uint32_t nodeInsert(BNode<_Tp>*, const _Tp) noexcept;
 
 		_Tp nodeDelete(BNode<_Tp>*, uint32_t) noexcept;
@@ -73,8 +219,20 @@ class BTree {
 
 		void printNode(std::ostream&, const BNode<_Tp>*, const uint32_t) const noexcept;
 
+		[[noreturn]] void missingKey(const _Tp&) const;
+
+		uint64_t packCount(const uint64_t, const uint32_t) const noexcept;
+
+		template <class Iterator>
+		void packLeaves(Iterator, const uint64_t, const uint64_t, const uint64_t, const uint64_t, std::vector<BNode<_Tp>*>&, std::vector<_Tp>&);
+
 	public:
-		explicit BTree(const uint32_t, bool (*)(const _Tp&, const _Tp&), void (*)(const _Tp&) = nullptr);
+		using iterator = BTreeIterator<_Tp>;
+		using const_iterator = BTreeIterator<_Tp>;
+
+		explicit BTree(const uint32_t, const Compare& = Compare(), void (*)(const _Tp&) = nullptr, std::pmr::memory_resource* = std::pmr::get_default_resource());
+
+		explicit BTree(const uint32_t, bool (*)(const _Tp&, const _Tp&), void (*)(const _Tp&) = nullptr, std::pmr::memory_resource* = std::pmr::get_default_resource());
 
 		~BTree(void);
 
@@ -88,82 +246,356 @@ class BTree {
 
 		constexpr uint64_t size_in_bytes(void) const noexcept;
 
+		uint64_t memory_in_bytes(void) const noexcept;
+
+		BTree snapshot(void) const noexcept;
+
+		FrozenBTree<_Tp, Compare> freeze(void) const;
+
 		void insert(const _Tp) noexcept;
 
+		template <class Iterator>
+		void bulk_load(Iterator, Iterator, const double = 1.0, const uint32_t = 1);
+
 		_Tp remove(const _Tp);
 
+		std::optional<_Tp> try_remove(const _Tp) noexcept;
+
 		std::pair<const BNode<_Tp>*, uint32_t> search(const _Tp) const noexcept;
 
+		std::optional<_Tp> find(const _Tp) const noexcept;
+
+		bool contains(const _Tp) const noexcept;
+
 		_Tp searchKey(const _Tp) const;
 
-		friend std::ostream& operator<< <>(std::ostream&, const BTree<_Tp>&);
+		iterator begin(void) const noexcept;
+
+		iterator end(void) const noexcept;
+
+		iterator lower_bound(const _Tp&) const noexcept;
+
+		iterator upper_bound(const _Tp&) const noexcept;
+
+		std::pair<iterator, iterator> equal_range(const _Tp&) const noexcept;
+
+		template <class Callback>
+		uint64_t scan(const _Tp&, const _Tp&, Callback) const;
+
+		friend std::ostream& operator<< <>(std::ostream&, const BTree&);
 };
 
 template <typename _Tp>
-BNode<_Tp>::BNode(const uint32_t minDegree)
-	: size(0), leaf(true) {
-	key = new _Tp[2 * minDegree - 1];
-	child = new BNode<_Tp>*[2 * minDegree];
+BTree(const uint32_t, bool (*)(const _Tp&, const _Tp&), void (*)(const _Tp&) = nullptr, std::pmr::memory_resource* = std::pmr::get_default_resource()) -> BTree<_Tp, BTreeLessThan<_Tp>>;
 
-	for (uint32_t i = 0; i < 2 * minDegree; i++) {
-		child[i] = nullptr;
-	}
+template <typename _Tp>
+constexpr uint64_t BNode<_Tp>::keyOffset(void) noexcept {
+	return (sizeof(BNode) + alignof(_Tp) - 1) / alignof(_Tp) * alignof(_Tp);
 }
 
 template <typename _Tp>
-BNode<_Tp>::~BNode(void) {
-	delete[] child;
-	delete[] key;
+uint64_t BNode<_Tp>::childOffset(const uint32_t minDegree) noexcept {
+	const uint64_t keysEnd = keyOffset() + (2 * minDegree - 1) * sizeof(_Tp);
+	return (keysEnd + alignof(BNode*) - 1) / alignof(BNode*) * alignof(BNode*);
 }
 
 template <typename _Tp>
-void BNode<_Tp>::deepClean(void) noexcept {
+uint64_t BNode<_Tp>::blockSize(const uint32_t minDegree, const bool leaf) noexcept {
+	const uint64_t bytes = leaf ? keyOffset() + (2 * minDegree - 1) * sizeof(_Tp) : childOffset(minDegree) + 2 * minDegree * sizeof(BNode*);
+	return (bytes + _BTREE_NODE_ALIGNMENT - 1) / _BTREE_NODE_ALIGNMENT * _BTREE_NODE_ALIGNMENT;
+}
+
+template <typename _Tp>
+BNode<_Tp>::BNode(const uint32_t minDegree, const bool isLeaf) noexcept
+	: child(nullptr), size(0), refs(1), leaf(isLeaf) {
+	key = reinterpret_cast<_Tp*>(reinterpret_cast<char*>(this) + keyOffset());
+	for (uint32_t i = 0; i < 2 * minDegree - 1; i++) {
+		new (key + i) _Tp();
+	}
+
 	if (not leaf) {
-		for (uint32_t i = 0; i <= size; i++) {
-			child[i]->deepClean();
+		child = reinterpret_cast<BNode**>(reinterpret_cast<char*>(this) + childOffset(minDegree));
+		for (uint32_t i = 0; i < 2 * minDegree; i++) {
+			child[i] = nullptr;
 		}
 	}
+}
 
-	delete[] child;
-	delete[] key;
+template <typename _Tp>
+BNode<_Tp>* BNode<_Tp>::create(void* block, const uint32_t minDegree, const bool leaf) noexcept {
+	return new (block) BNode(minDegree, leaf);
 }
 
 template <typename _Tp>
-BTree<_Tp>::BTree(const uint32_t deg, bool (*compare)(const _Tp&, const _Tp&), void (*printK)(const _Tp&))
-	: minDegree(deg), lessThan(compare), printKey(printK), keyCount(0), heightCount(0) {
-	root = new BNode<_Tp>(minDegree);
+void BNode<_Tp>::destroy(BNode* node, const uint32_t minDegree) noexcept {
+	for (uint32_t i = 0; i < 2 * minDegree - 1; i++) {
+		node->key[i].~_Tp();
+	}
+
+	node->~BNode();
 }
 
 template <typename _Tp>
-BTree<_Tp>::~BTree(void) {
-	freeNode(root);
+BTreeIterator<_Tp>::BTreeIterator(void) noexcept
+	: depth(0), root(nullptr) {}
+
+template <typename _Tp>
+BTreeIterator<_Tp>::BTreeIterator(const BNode<_Tp>* node) noexcept
+	: depth(0), root(node) {}
+
+template <typename _Tp>
+void BTreeIterator<_Tp>::pushLeftmost(const BNode<_Tp>* node) noexcept {
+	while (true) {
+		path[depth++] = std::make_pair(node, 0);
+		if (node->leaf) {
+			return;
+		}
+
+		node = node->child[0];
+	}
 }
 
 template <typename _Tp>
-BTree<_Tp>::BTree(const BTree& btree)
+void BTreeIterator<_Tp>::pushRightmost(const BNode<_Tp>* node) noexcept {
+	while (not node->leaf) {
+		path[depth++] = std::make_pair(node, node->size);
+		node = node->child[node->size];
+	}
+
+	path[depth++] = std::make_pair(node, node->size - 1);
+}
+
+template <typename _Tp>
+void BTreeIterator<_Tp>::ascendForward(void) noexcept {
+	while (depth and path[depth - 1].second >= path[depth - 1].first->size) {
+		depth--;
+	}
+}
+
+template <typename _Tp>
+void BTreeIterator<_Tp>::ascendBackward(void) noexcept {
+	while (depth and path[depth - 1].second == 0) {
+		depth--;
+	}
+
+	if (depth) {
+		path[depth - 1].second--;
+	}
+}
+
+template <typename _Tp>
+typename BTreeIterator<_Tp>::reference BTreeIterator<_Tp>::operator*(void) const noexcept {
+	return path[depth - 1].first->key[path[depth - 1].second];
+}
+
+template <typename _Tp>
+typename BTreeIterator<_Tp>::pointer BTreeIterator<_Tp>::operator->(void) const noexcept {
+	return path[depth - 1].first->key + path[depth - 1].second;
+}
+
+template <typename _Tp>
+BTreeIterator<_Tp>& BTreeIterator<_Tp>::operator++(void) noexcept {
+	std::pair<const BNode<_Tp>*, uint32_t>& top = path[depth - 1];
+
+	if (not top.first->leaf) {
+		top.second++;
+		pushLeftmost(top.first->child[top.second]);
+	}
+
+	else {
+		top.second++;
+		ascendForward();
+	}
+
+	return *this;
+}
+
+template <typename _Tp>
+BTreeIterator<_Tp> BTreeIterator<_Tp>::operator++(int) noexcept {
+	BTreeIterator<_Tp> old = *this;
+	++*this;
+	return old;
+}
+
+template <typename _Tp>
+BTreeIterator<_Tp>& BTreeIterator<_Tp>::operator--(void) noexcept {
+	if (not depth) {
+		if (root->size) {
+			pushRightmost(root);
+		}
+
+		return *this;
+	}
+
+	std::pair<const BNode<_Tp>*, uint32_t>& top = path[depth - 1];
+
+	if (not top.first->leaf) {
+		pushRightmost(top.first->child[top.second]);
+	}
+
+	else {
+		ascendBackward();
+	}
+
+	return *this;
+}
+
+template <typename _Tp>
+BTreeIterator<_Tp> BTreeIterator<_Tp>::operator--(int) noexcept {
+	BTreeIterator<_Tp> old = *this;
+	--*this;
+	return old;
+}
+
+template <typename _Tp>
+bool BTreeIterator<_Tp>::operator==(const BTreeIterator& other) const noexcept {
+	if (depth != other.depth) {
+		return false;
+	}
+
+	return not depth or path[depth - 1] == other.path[depth - 1];
+}
+
+template <typename _Tp>
+bool BTreeIterator<_Tp>::operator!=(const BTreeIterator& other) const noexcept {
+	return not (*this == other);
+}
+
+template <typename _Tp, class Cmp, class KT>
+BTree<_Tp, Cmp, KT>::BTree(const uint32_t deg, const Cmp& compare, void (*printK)(const _Tp&), std::pmr::memory_resource* upstream)
+	: minDegree(deg), lessThan(compare), printKey(printK), keyCount(0), heightCount(0),
+	store(std::make_shared<NodeStore>(deg, upstream)) {
+	root = allocateNode(true);
+}
+
+template <typename _Tp, class Cmp, class KT>
+BTree<_Tp, Cmp, KT>::BTree(const uint32_t deg, bool (*compare)(const _Tp&, const _Tp&), void (*printK)(const _Tp&), std::pmr::memory_resource* upstream)
+	: minDegree(deg), lessThan(compare), printKey(printK), keyCount(0), heightCount(0),
+	store(std::make_shared<NodeStore>(deg, upstream)) {
+	static_assert(std::is_constructible<Cmp, bool (*)(const _Tp&, const _Tp&)>::value, "function-pointer comparators need Compare = BTreeLessThan<_Tp>; declare the tree as BTree tree(deg, compare)");
+	root = allocateNode(true);
+}
+
+template <typename _Tp, class Cmp, class KT>
+BTree<_Tp, Cmp, KT>::~BTree(void) {
+	clear();
+}
+
+template <typename _Tp, class Cmp, class KT>
+BTree<_Tp, Cmp, KT>::BTree(const BTree& btree)
 	: minDegree(btree.minDegree), lessThan(btree.lessThan), printKey(btree.printKey),
-	keyCount(btree.keyCount), heightCount(btree.heightCount) {
+	keyCount(btree.keyCount), heightCount(btree.heightCount),
+	store(std::make_shared<NodeStore>(btree.minDegree, btree.store->leafPool.upstream_resource())) {
 	copyNode(root, btree.root);
 }
 
-template <typename _Tp>
-BTree<_Tp>& BTree<_Tp>::operator=(const BTree& btree) {
+template <typename _Tp, class Cmp, class KT>
+BTree<_Tp, Cmp, KT>::BTree(const BTree& btree, const std::shared_ptr<NodeStore>& shared) noexcept
+	: root(btree.root), minDegree(btree.minDegree), lessThan(btree.lessThan), printKey(btree.printKey),
+	keyCount(btree.keyCount), heightCount(btree.heightCount), store(shared) {
+	root->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename _Tp, class Cmp, class KT>
+BTree<_Tp, Cmp, KT>::NodeStore::NodeStore(const uint32_t deg, std::pmr::memory_resource* upstream)
+	: leafPool(BNode<_Tp>::blockSize(deg, true), _BTREE_NODE_ALIGNMENT, upstream),
+	internalPool(BNode<_Tp>::blockSize(deg, false), _BTREE_NODE_ALIGNMENT, upstream), nodeBytes(0) {}
+
+template <typename _Tp, class Cmp, class KT>
+BTree<_Tp, Cmp, KT>& BTree<_Tp, Cmp, KT>::operator=(const BTree& btree) {
 	if (minDegree != btree.minDegree)
 		throw std::bad_alloc();
 
+	if (this == &btree) {
+		return *this;
+	}
+
+	clear();
 	keyCount = btree.keyCount;
 	heightCount = btree.heightCount;
-	freeNode(root);
 	copyNode(root, btree.root);
 
 	return *this;
 }
 
-template <typename _Tp>
-void BTree<_Tp>::copyNode(BNode<_Tp>*& dest, const BNode<_Tp>* src) noexcept {
-	dest = new BNode<_Tp>(minDegree);
+template <typename _Tp, class Cmp, class KT>
+BNode<_Tp>* BTree<_Tp, Cmp, KT>::allocateNode(const bool leaf) {
+	NodePool& pool = leaf ? store->leafPool : store->internalPool;
+	store->nodeBytes.fetch_add(pool.block_size(), std::memory_order_relaxed);
+	return BNode<_Tp>::create(pool.allocate_block(), minDegree, leaf);
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BTree<_Tp, Cmp, KT>::releaseNode(BNode<_Tp>* node) noexcept {
+	NodePool& pool = node->leaf ? store->leafPool : store->internalPool;
+	store->nodeBytes.fetch_sub(pool.block_size(), std::memory_order_relaxed);
+	BNode<_Tp>::destroy(node, minDegree);
+	pool.release_block(node);
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BTree<_Tp, Cmp, KT>::dropNode(BNode<_Tp>* node) noexcept {
+	if (node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+		return;
+	}
+
+	if (not node->leaf) {
+		for (uint32_t i = 0; i <= node->size; i++) {
+			dropNode(node->child[i]);
+		}
+	}
+
+	releaseNode(node);
+}
+
+template <typename _Tp, class Cmp, class KT>
+BNode<_Tp>* BTree<_Tp, Cmp, KT>::writable(BNode<_Tp>*& slot) {
+	BNode<_Tp>* node = slot;
+	if (node->refs.load(std::memory_order_acquire) == 1) {
+		return node;
+	}
+
+	BNode<_Tp>* copy = allocateNode(node->leaf);
+	copy->size = node->size;
+
+	for (uint32_t i = 0; i < node->size; i++) {
+		copy->key[i] = node->key[i];
+	}
+
+	if (not node->leaf) {
+		for (uint32_t i = 0; i <= node->size; i++) {
+			copy->child[i] = node->child[i];
+			copy->child[i]->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	dropNode(node);
+	slot = copy;
+	return copy;
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BTree<_Tp, Cmp, KT>::clear(void) noexcept {
+	if (root and store.use_count() > 1) {
+		dropNode(root);
+		root = nullptr;
+		return;
+	}
+
+	if constexpr (not std::is_trivially_destructible<_Tp>::value) {
+		freeNode(root);
+	}
+
+	store->leafPool.release_all();
+	store->internalPool.release_all();
+	store->nodeBytes = 0;
+	root = nullptr;
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BTree<_Tp, Cmp, KT>::copyNode(BNode<_Tp>*& dest, const BNode<_Tp>* src) noexcept {
+	dest = allocateNode(src->leaf);
 	dest->size = src->size;
-	dest->leaf = src->leaf;
 
 	for (uint32_t i = 0; i < src->size; i++) {
 		dest->key[i] = src->key[i];
@@ -176,8 +608,19 @@ void BTree<_Tp>::copyNode(BNode<_Tp>*& dest, const BNode<_Tp>* src) noexcept {
 	}
 }
 
-template <typename _Tp>
-void BTree<_Tp>::freeNode(BNode<_Tp>* node) {
+template <typename _Tp, class Cmp, class KT>
+bool BTree<_Tp, Cmp, KT>::equal(const _Tp& a, const _Tp& b) const noexcept {
+	if constexpr (KT::fixed_width and std::is_same<Cmp, std::less<_Tp>>::value) {
+		return a == b;
+	}
+
+	else {
+		return not (lessThan(a, b) or lessThan(b, a));
+	}
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BTree<_Tp, Cmp, KT>::freeNode(BNode<_Tp>* node) {
 	if (node == nullptr)
 		throw std::runtime_error("nullptr bad deallocation");
 
@@ -187,54 +630,154 @@ void BTree<_Tp>::freeNode(BNode<_Tp>* node) {
 		}
 	}
 
-	delete node;
+	releaseNode(node);
 }
 
-template <typename _Tp>
-uint32_t BTree<_Tp>::findIndex(const BNode<_Tp>* node, const _Tp key) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+uint32_t BTree<_Tp, Cmp, KT>::findIndex(const BNode<_Tp>* node, const _Tp key) const noexcept {
+#if defined(__AVX2__)
+	if constexpr (KT::search == _BTREE_SEARCH_SIMD and std::is_same<Cmp, std::less<_Tp>>::value) {
+		return simdIndex(node->key, node->size, key);
+	}
+#endif
+
+	if constexpr (KT::search == _BTREE_SEARCH_LINEAR) {
+		return linearIndex(node->key, node->size, key);
+	}
+
+	else {
+		return binaryIndex(node->key, node->size, key);
+	}
+}
+
+template <typename _Tp, class Cmp, class KT>
+uint32_t BTree<_Tp, Cmp, KT>::upperIndex(const BNode<_Tp>* node, const _Tp& key) const noexcept {
+	if (node->size == 0) {
+		return 0;
+	}
+
+	const _Tp* base = node->key;
+	for (uint32_t n = node->size; n > 1; ) {
+		const uint32_t half = n / 2;
+		base = lessThan(key, base[half]) ? base : base + half;
+		n -= half;
+	}
+
+	return (base - node->key) + not lessThan(key, *base);
+}
+
+template <typename _Tp, class Cmp, class KT>
+uint32_t BTree<_Tp, Cmp, KT>::linearIndex(const _Tp* keys, const uint32_t size, const _Tp& key) const noexcept {
 	uint32_t i = 0;
-	while (i < node->size and lessThan(node->key[i], key)) {
+	while (i < size and lessThan(keys[i], key)) {
 		i++;
 	}
-	
+
 	return i;
 }
 
-template <typename _Tp>
-uint32_t BTree<_Tp>::nodeInsert(BNode<_Tp>* node, const _Tp key) noexcept {
+template <typename _Tp, class Cmp, class KT>
+uint32_t BTree<_Tp, Cmp, KT>::binaryIndex(const _Tp* keys, const uint32_t size, const _Tp& key) const noexcept {
+	if (size == 0) {
+		return 0;
+	}
+
+	const _Tp* base = keys;
+	for (uint32_t n = size; n > 1; ) {
+		const uint32_t half = n / 2;
+		base = lessThan(base[half], key) ? base + half : base;
+		n -= half;
+	}
+
+	return (base - keys) + lessThan(*base, key);
+}
+
+template <typename _Tp, class Cmp, class KT>
+uint32_t BTree<_Tp, Cmp, KT>::simdIndex(const _Tp* keys, const uint32_t size, const _Tp& key) noexcept {
+	const _Tp* base = keys;
+	uint32_t n = size, i = 0;
+
+#if defined(__AVX2__)
+	constexpr uint32_t lanes = 32 / sizeof(_Tp);
+	for (; n > 2 * lanes; ) {
+		const uint32_t half = n / 2;
+		base = base[half] < key ? base + half : base;
+		n -= half;
+	}
+
+	uint32_t count = base - keys;
+	const _Tp bias = std::is_signed<_Tp>::value ? _Tp(0) : _Tp(_Tp(1) << (8 * sizeof(_Tp) - 1));
+
+	if constexpr (sizeof(_Tp) == 4) {
+		const __m256i flip = _mm256_set1_epi32(int32_t(bias));
+		const __m256i needle = _mm256_xor_si256(_mm256_set1_epi32(int32_t(key)), flip);
+
+		for (; i + lanes <= n; i += lanes) {
+			__m256i block = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (base + i)), flip);
+			count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, block))));
+		}
+	}
+
+	else if constexpr (sizeof(_Tp) == 8) {
+		const __m256i flip = _mm256_set1_epi64x(int64_t(bias));
+		const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(int64_t(key)), flip);
+
+		for (; i + lanes <= n; i += lanes) {
+			__m256i block = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (base + i)), flip);
+			count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, block))));
+		}
+	}
+#else
+	uint32_t count = 0;
+#endif
+
+	for (; i < n; i++) {
+		count += base[i] < key;
+	}
+
+	return count;
+}
+
+template <typename _Tp, class Cmp, class KT>
+uint32_t BTree<_Tp, Cmp, KT>::nodeInsert(BNode<_Tp>* node, const _Tp key) noexcept {
 	uint32_t index;
 
 	for (index = node->size; index > 0 and lessThan(key, node->key[index - 1]); index--) {
 		node->key[index] = node->key[index - 1];
-		node->child[index + 1] = node->child[index];
+		if (not node->leaf) {
+			node->child[index + 1] = node->child[index];
+		}
 	}
 
-	node->child[index + 1] = node->child[index];
+	if (not node->leaf) {
+		node->child[index + 1] = node->child[index];
+	}
 	node->key[index] = key;
 	node->size++;
 
 	return index;
 }
 
-template <typename _Tp>
-_Tp BTree<_Tp>::nodeDelete(BNode<_Tp>* node, uint32_t index) noexcept {
+template <typename _Tp, class Cmp, class KT>
+_Tp BTree<_Tp, Cmp, KT>::nodeDelete(BNode<_Tp>* node, uint32_t index) noexcept {
 	_Tp toReturn = node->key[index];
 	node->size--;
 
 	while (index < node->size) {
 		node->key[index] = node->key[index + 1];
-		node->child[index + 1] = node->child[index + 2];
+		if (not node->leaf) {
+			node->child[index + 1] = node->child[index + 2];
+		}
 		index++;
 	}
 
 	return toReturn;
 }
 
-template <typename _Tp>
-void BTree<_Tp>::splitChild(BNode<_Tp>* par, const uint32_t index) noexcept {
+template <typename _Tp, class Cmp, class KT>
+void BTree<_Tp, Cmp, KT>::splitChild(BNode<_Tp>* par, const uint32_t index) noexcept {
 	BNode<_Tp>* toSplit = par->child[index];
-	BNode<_Tp>* newNode = new BNode<_Tp>(minDegree);
-	newNode->leaf = toSplit->leaf;
+	BNode<_Tp>* newNode = allocateNode(toSplit->leaf);
 	newNode->size = minDegree - 1;
 
 	for (uint32_t j = 0; j < minDegree - 1; j++) {
@@ -247,30 +790,40 @@ void BTree<_Tp>::splitChild(BNode<_Tp>* par, const uint32_t index) noexcept {
 	}
 	toSplit->size = minDegree - 1;
 
-	nodeInsert(par, toSplit->key[minDegree - 1]);
+	for (uint32_t j = par->size; j > index; j--) {
+		par->key[j] = par->key[j - 1];
+		par->child[j + 1] = par->child[j];
+	}
+
+	par->key[index] = toSplit->key[minDegree - 1];
 	par->child[index + 1] = newNode;
+	par->size++;
 }
 
-template <typename _Tp>
-uint8_t BTree<_Tp>::mergeChildren(BNode<_Tp>* par, const uint32_t index) noexcept {
-	BNode<_Tp>* leftChild = par->child[index];
-	BNode<_Tp>* rightChild = par->child[index + 1];
+template <typename _Tp, class Cmp, class KT>
+uint8_t BTree<_Tp, Cmp, KT>::mergeChildren(BNode<_Tp>* par, const uint32_t index) noexcept {
+	BNode<_Tp>* leftChild = writable(par->child[index]);
+	BNode<_Tp>* rightChild = writable(par->child[index + 1]);
 
 	leftChild->key[leftChild->size] = nodeDelete(par, index);
 	uint32_t j = ++ leftChild->size;
 
 	for (uint32_t k = 0; k < rightChild->size; k++) {
 		leftChild->key[j + k] = rightChild->key[k];
-		leftChild->child[j + k] = rightChild->child[k];
+		if (not leftChild->leaf) {
+			leftChild->child[j + k] = rightChild->child[k];
+		}
 	}
 	leftChild->size += rightChild->size;
-	leftChild->child[leftChild->size] = rightChild->child[rightChild->size];
+	if (not leftChild->leaf) {
+		leftChild->child[leftChild->size] = rightChild->child[rightChild->size];
+	}
 
-	delete rightChild;
+	releaseNode(rightChild);
 
 	if (par->size == 0) {
 		root = leftChild;
-		delete par;
+		releaseNode(par);
 		heightCount--;
 		return _BTREE_NEW_ROOT;
 	}
@@ -278,27 +831,34 @@ uint8_t BTree<_Tp>::mergeChildren(BNode<_Tp>* par, const uint32_t index) noexcep
 	return _BTREE_MODIFIED_NOT_ROOT;
 }
 
-template <typename _Tp>
-uint8_t BTree<_Tp>::fixChildSize(BNode<_Tp>* par, const uint32_t index) noexcept {
+template <typename _Tp, class Cmp, class KT>
+uint8_t BTree<_Tp, Cmp, KT>::fixChildSize(BNode<_Tp>* par, const uint32_t index) noexcept {
 	BNode<_Tp>* child = par->child[index];
 
 	if (child->size < minDegree) {
 		if (index > 0 and par->child[index - 1]->size >= minDegree) {
-			BNode<_Tp>* leftSibling = par->child[index - 1];
+			child = writable(par->child[index]);
+			BNode<_Tp>* leftSibling = writable(par->child[index - 1]);
 
-			for (uint32_t i = nodeInsert(child, par->key[index - 1]); i > 0; i--) {
-				child->child[i] = child->child[i - 1];
+			uint32_t i = nodeInsert(child, par->key[index - 1]);
+			if (not child->leaf) {
+				for (; i > 0; i--) {
+					child->child[i] = child->child[i - 1];
+				}
+
+				child->child[0] = leftSibling->child[leftSibling->size];
 			}
-			
-			child->child[0] = leftSibling->child[leftSibling->size];
 			par->key[index - 1] = nodeDelete(leftSibling, leftSibling->size - 1);
 		}
 
 		else if (index < par->size and par->child[index + 1]->size >= minDegree) {
-			BNode<_Tp>* rightSibling = par->child[index + 1];
+			child = writable(par->child[index]);
+			BNode<_Tp>* rightSibling = writable(par->child[index + 1]);
 			nodeInsert(child, par->key[index]);
-			child->child[child->size] = rightSibling->child[0];
-			rightSibling->child[0] = rightSibling->child[1];
+			if (not child->leaf) {
+				child->child[child->size] = rightSibling->child[0];
+				rightSibling->child[0] = rightSibling->child[1];
+			}
 			par->key[index] = nodeDelete(rightSibling, 0);
 		}
 
@@ -316,8 +876,8 @@ uint8_t BTree<_Tp>::fixChildSize(BNode<_Tp>* par, const uint32_t index) noexcept
 	return _BTREE_NOT_MODIFIED;
 }
 
-template <typename _Tp>
-void BTree<_Tp>::printNode(std::ostream& out, const BNode<_Tp>* node, const uint32_t indent) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+void BTree<_Tp, Cmp, KT>::printNode(std::ostream& out, const BNode<_Tp>* node, const uint32_t indent) const noexcept {
 	for (uint32_t i = 0; i < indent; i++) {
 		out << "\t";
 	}
@@ -334,26 +894,62 @@ void BTree<_Tp>::printNode(std::ostream& out, const BNode<_Tp>* node, const uint
 	}
 }
 
-template <typename _Tp>
-constexpr uint32_t BTree<_Tp>::num_keys(void) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+void BTree<_Tp, Cmp, KT>::missingKey(const _Tp& key) const {
+	if (printKey == nullptr) {
+		throw std::out_of_range("_BTREE_KEY_NOT_FOUND");
+	}
+
+	std::stringstream newbuf;
+	std::streambuf* oldbuf = std::cout.rdbuf(newbuf.rdbuf());
+	printKey(key);
+	std::cout.rdbuf(oldbuf);
+	throw std::out_of_range("_BTREE_KEY_NOT_FOUND: " + newbuf.str());
+}
+
+template <typename _Tp, class Cmp, class KT>
+constexpr uint32_t BTree<_Tp, Cmp, KT>::num_keys(void) const noexcept {
 	return keyCount;
 }
 
-template <typename _Tp>
-constexpr uint32_t BTree<_Tp>::height(void) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+constexpr uint32_t BTree<_Tp, Cmp, KT>::height(void) const noexcept {
 	return heightCount;
 }
 
-template <typename _Tp>
-constexpr uint64_t BTree<_Tp>::size_in_bytes(void) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+constexpr uint64_t BTree<_Tp, Cmp, KT>::size_in_bytes(void) const noexcept {
 	return keyCount * sizeof(_Tp);
 }
 
-template <typename _Tp>
-void BTree<_Tp>::insert(const _Tp key) noexcept {
-	if (root->size == 2 * minDegree - 1) {
-		BNode<_Tp>* newRoot = new BNode<_Tp>(minDegree);
-		newRoot->leaf = false;
+template <typename _Tp, class Cmp, class KT>
+uint64_t BTree<_Tp, Cmp, KT>::memory_in_bytes(void) const noexcept {
+	return store->nodeBytes.load(std::memory_order_relaxed);
+}
+
+template <typename _Tp, class Cmp, class KT>
+BTree<_Tp, Cmp, KT> BTree<_Tp, Cmp, KT>::snapshot(void) const noexcept {
+	return BTree(*this, store);
+}
+
+template <typename _Tp, class Cmp, class KT>
+FrozenBTree<_Tp, Cmp> BTree<_Tp, Cmp, KT>::freeze(void) const {
+	std::vector<_Tp> sorted;
+	sorted.reserve(keyCount);
+
+	if (keyCount) {
+		scan(*begin(), *std::prev(end()), [&](const _Tp& key) {
+			sorted.push_back(key);
+		});
+	}
+
+	return FrozenBTree<_Tp, Cmp>(sorted.begin(), sorted.end(), lessThan, store->leafPool.upstream_resource());
+}
+
+template <typename _Tp, class Cmp, class KT>
+void BTree<_Tp, Cmp, KT>::insert(const _Tp key) noexcept {
+	if (writable(root)->size == 2 * minDegree - 1) {
+		BNode<_Tp>* newRoot = allocateNode(false);
 		newRoot->child[0] = root;
 		root = newRoot;
 		splitChild(newRoot, 0);
@@ -362,13 +958,9 @@ void BTree<_Tp>::insert(const _Tp key) noexcept {
 
 	BNode<_Tp>* curr = root;
 	while (not curr->leaf) {
-		uint32_t index = curr->size - 1;
-		while (index >= 0 and lessThan(key, curr->key[index])) {
-			index--;
-		}
-		index++;
+		uint32_t index = findIndex(curr, key);
 
-		if (curr->child[index]->size == 2 * minDegree - 1) {
+		if (writable(curr->child[index])->size == 2 * minDegree - 1) {
 			splitChild(curr, index);
 			if (lessThan(curr->key[index], key)) {
 				index++;
@@ -382,14 +974,137 @@ void BTree<_Tp>::insert(const _Tp key) noexcept {
 	keyCount++;
 }
 
-template <typename _Tp>
-_Tp BTree<_Tp>::remove(const _Tp key) {
-	BNode<_Tp>* curr = root;
+template <typename _Tp, class Cmp, class KT>
+uint64_t BTree<_Tp, Cmp, KT>::packCount(const uint64_t keys, const uint32_t capacity) const noexcept {
+	const uint64_t fewest = (keys + 2 * minDegree) / (2 * minDegree);
+	const uint64_t most = (keys + 1) / minDegree;
+	const uint64_t target = (keys + capacity + 1) / (capacity + 1);
+
+	return std::max<uint64_t>(1, std::max(fewest, std::min(target, most)));
+}
+
+template <typename _Tp, class Cmp, class KT>
+template <class Iterator>
+void BTree<_Tp, Cmp, KT>::packLeaves(Iterator first, const uint64_t begin, const uint64_t end, const uint64_t base, const uint64_t extra,
+	std::vector<BNode<_Tp>*>& leaves, std::vector<_Tp>& separators) {
+	Iterator it = std::next(first, begin * (base + 1) + std::min(begin, extra));
+
+	for (uint64_t i = begin; i < end; i++) {
+		BNode<_Tp>* leaf = BNode<_Tp>::create(store->leafPool.allocate_block(), minDegree, true);
+		leaf->size = base + (i < extra);
+
+		for (uint32_t j = 0; j < leaf->size; j++, ++it) {
+			leaf->key[j] = *it;
+		}
+
+		if (i + 1 < leaves.size()) {
+			separators[i] = *it;
+			++it;
+		}
+
+		leaves[i] = leaf;
+	}
+}
+
+template <typename _Tp, class Cmp, class KT>
+template <class Iterator>
+void BTree<_Tp, Cmp, KT>::bulk_load(Iterator first, Iterator last, const double fill_factor, const uint32_t threads) {
+	if (first != last) {
+		for (Iterator prev = first, curr = std::next(first); curr != last; prev = curr++) {
+			if (lessThan(*curr, *prev)) {
+				throw std::invalid_argument("_BTREE_UNSORTED_INPUT");
+			}
+		}
+	}
+
+	const uint64_t keys = std::distance(first, last);
+	const uint32_t capacity = std::clamp<uint32_t>(fill_factor * (2 * minDegree - 1), std::max<uint32_t>(1, minDegree - 1), 2 * minDegree - 1);
+
+	clear();
+	keyCount = keys;
+	heightCount = 0;
+
+	if (not keys) {
+		root = allocateNode(true);
+		return;
+	}
+
+	uint64_t count = packCount(keys, capacity);
+	uint64_t base = (keys + 1 - count) / count;
+	uint64_t extra = (keys + 1 - count) % count;
+
+	std::vector<BNode<_Tp>*> nodes(count);
+	std::vector<_Tp> separators(count - 1);
+
+	const uint64_t workers = std::max<uint64_t>(1, std::min<uint64_t>(threads, count));
+	std::vector<std::thread> pool;
+
+	for (uint64_t w = 1; w < workers; w++) {
+		pool.emplace_back([&, w] {
+			packLeaves(first, count * w / workers, count * (w + 1) / workers, base, extra, nodes, separators);
+		});
+	}
+
+	packLeaves(first, 0, count / workers, base, extra, nodes, separators);
+	for (std::thread& worker : pool) {
+		worker.join();
+	}
+
+	store->nodeBytes.fetch_add(count * store->leafPool.block_size(), std::memory_order_relaxed);
+
+	while (nodes.size() > 1) {
+		const uint64_t size = separators.size();
+		count = packCount(size, capacity);
+		base = (size + 1 - count) / count;
+		extra = (size + 1 - count) % count;
+
+		std::vector<BNode<_Tp>*> parents(count);
+		std::vector<_Tp> promoted(count - 1);
+
+		for (uint64_t i = 0, start = 0; i < count; i++) {
+			BNode<_Tp>* node = allocateNode(false);
+			node->size = base + (i < extra);
+
+			for (uint32_t j = 0; j < node->size; j++) {
+				node->key[j] = separators[start + j];
+				node->child[j] = nodes[start + j];
+			}
+
+			node->child[node->size] = nodes[start + node->size];
+			if (i + 1 < count) {
+				promoted[i] = separators[start + node->size];
+			}
+
+			parents[i] = node;
+			start += node->size + 1;
+		}
+
+		nodes.swap(parents);
+		separators.swap(promoted);
+		heightCount++;
+	}
+
+	root = nodes[0];
+}
+
+template <typename _Tp, class Cmp, class KT>
+_Tp BTree<_Tp, Cmp, KT>::remove(const _Tp key) {
+	std::optional<_Tp> removed = try_remove(key);
+	if (not removed) {
+		missingKey(key);
+	}
+
+	return *removed;
+}
+
+template <typename _Tp, class Cmp, class KT>
+std::optional<_Tp> BTree<_Tp, Cmp, KT>::try_remove(const _Tp key) noexcept {
+	BNode<_Tp>* curr = writable(root);
 
 	while (true) {
 		uint32_t i = findIndex(curr, key);
 		
-		if (i < curr->size and not (lessThan(curr->key[i], key) or lessThan(key, curr->key[i]))) {
+		if (i < curr->size and equal(curr->key[i], key)) {
 			_Tp toReturn = curr->key[i];
 			if (curr->leaf) {
 				nodeDelete(curr, i);
@@ -400,65 +1115,60 @@ _Tp BTree<_Tp>::remove(const _Tp key) {
 				BNode<_Tp>* rightChild = curr->child[i + 1];
 
 				if (leftChild->size >= minDegree) {
+					leftChild = writable(curr->child[i]);
 					while (not leftChild->leaf) {
 						fixChildSize(leftChild, leftChild->size);
-						leftChild = leftChild->child[leftChild->size];
+						leftChild = writable(leftChild->child[leftChild->size]);
 					}
 					curr->key[i] = nodeDelete(leftChild, leftChild->size - 1);
 				}
 
 				else if (rightChild->size >= minDegree) {
+					rightChild = writable(curr->child[i + 1]);
 					while (not rightChild->leaf) {
 						fixChildSize(rightChild, 0);
-						rightChild = rightChild->child[0];
+						rightChild = writable(rightChild->child[0]);
 					}
 					curr->key[i] = nodeDelete(rightChild, 0);
 				}
 
 				else {
+					leftChild = writable(curr->child[i]);
 					mergeChildren(curr, i);
 					curr = leftChild;
 					continue;
 				}
 			}
 
+			keyCount--;
 			return toReturn;
 		}
 
 		else {
 			if (curr->leaf) {
-				if (printKey == nullptr) {
-					throw std::out_of_range("_BTREE_KEY_NOT_FOUND");
-				}
-		
-				std::stringstream newbuf;
-				std::streambuf* oldbuf = std::cout.rdbuf(newbuf.rdbuf());
-				printKey(key);
-				std::cout.rdbuf(oldbuf);
-				throw std::out_of_range("_BTREE_KEY_NOT_FOUND: " + newbuf.str());
+				return std::nullopt;
 			}
 
-			if (fixChildSize(curr, i) == _BTREE_NEW_ROOT) {
+			const uint8_t status = fixChildSize(curr, i);
+			if (status == _BTREE_NEW_ROOT) {
 				curr = root;
 			}
 			
-			else {
-				curr = curr->child[findIndex(curr, key)];
+			else if (status == _BTREE_NOT_MODIFIED) {
+				curr = writable(curr->child[i]);
 			}
 		}
 	}
-
-	keyCount--;
 }
 
-template <typename _Tp>
-std::pair<const BNode<_Tp>*, uint32_t> BTree<_Tp>::search(const _Tp key) const noexcept {
+template <typename _Tp, class Cmp, class KT>
+std::pair<const BNode<_Tp>*, uint32_t> BTree<_Tp, Cmp, KT>::search(const _Tp key) const noexcept {
 	BNode<_Tp>* curr = root;
 	
 	while (true) {
 		uint32_t i = findIndex(curr, key);
 
-		if (i < curr->size and not (lessThan(key, curr->key[i]) or lessThan(curr->key[i], key))) {
+		if (i < curr->size and equal(key, curr->key[i])) {
 			return std::pair<const BNode<_Tp>*, uint32_t>(curr, i);
 		}
 		
@@ -472,26 +1182,152 @@ std::pair<const BNode<_Tp>*, uint32_t> BTree<_Tp>::search(const _Tp key) const n
 	}
 }
 
-template <typename _Tp>
-_Tp BTree<_Tp>::searchKey(const _Tp key) const {
+template <typename _Tp, class Cmp, class KT>
+std::optional<_Tp> BTree<_Tp, Cmp, KT>::find(const _Tp key) const noexcept {
 	std::pair<const BNode<_Tp>*, uint32_t> node = search(key);
 	if (node.first == nullptr) {
-		if (printKey == nullptr) {
-			throw std::out_of_range("_BTREE_KEY_NOT_FOUND");
-		}
+		return std::nullopt;
+	}
+
+	return node.first->key[node.second];
+}
 
-		std::stringstream newbuf;
-		std::streambuf* oldbuf = std::cout.rdbuf(newbuf.rdbuf());
-		printKey(key);
-		std::cout.rdbuf(oldbuf);
-		throw std::out_of_range("_BTREE_KEY_NOT_FOUND: " + newbuf.str());
+template <typename _Tp, class Cmp, class KT>
+bool BTree<_Tp, Cmp, KT>::contains(const _Tp key) const noexcept {
+	return search(key).first != nullptr;
+}
+
+template <typename _Tp, class Cmp, class KT>
+_Tp BTree<_Tp, Cmp, KT>::searchKey(const _Tp key) const {
+	std::optional<_Tp> found = find(key);
+	if (not found) {
+		missingKey(key);
 	}
 	
-	return node.first->key[node.second];
+	return *found;
 }
 
-template <typename _Tp>
-std::ostream& operator<<(std::ostream& out, const BTree<_Tp>& btree) {
+template <typename _Tp, class Cmp, class KT>
+typename BTree<_Tp, Cmp, KT>::iterator BTree<_Tp, Cmp, KT>::begin(void) const noexcept {
+	iterator it(root);
+	if (root->size) {
+		it.pushLeftmost(root);
+	}
+
+	return it;
+}
+
+template <typename _Tp, class Cmp, class KT>
+typename BTree<_Tp, Cmp, KT>::iterator BTree<_Tp, Cmp, KT>::end(void) const noexcept {
+	return iterator(root);
+}
+
+template <typename _Tp, class Cmp, class KT>
+typename BTree<_Tp, Cmp, KT>::iterator BTree<_Tp, Cmp, KT>::lower_bound(const _Tp& key) const noexcept {
+	iterator it(root);
+	const BNode<_Tp>* curr = root;
+
+	while (true) {
+		const uint32_t i = findIndex(curr, key);
+		it.path[it.depth++] = std::make_pair(curr, i);
+
+		if (curr->leaf) {
+			break;
+		}
+
+		curr = curr->child[i];
+	}
+
+	it.ascendForward();
+	return it;
+}
+
+template <typename _Tp, class Cmp, class KT>
+typename BTree<_Tp, Cmp, KT>::iterator BTree<_Tp, Cmp, KT>::upper_bound(const _Tp& key) const noexcept {
+	iterator it(root);
+	const BNode<_Tp>* curr = root;
+
+	while (true) {
+		const uint32_t i = upperIndex(curr, key);
+		it.path[it.depth++] = std::make_pair(curr, i);
+
+		if (curr->leaf) {
+			break;
+		}
+
+		curr = curr->child[i];
+	}
+
+	it.ascendForward();
+	return it;
+}
+
+template <typename _Tp, class Cmp, class KT>
+std::pair<typename BTree<_Tp, Cmp, KT>::iterator, typename BTree<_Tp, Cmp, KT>::iterator> BTree<_Tp, Cmp, KT>::equal_range(const _Tp& key) const noexcept {
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template <typename _Tp, class Cmp, class KT>
+template <class Callback>
+uint64_t BTree<_Tp, Cmp, KT>::scan(const _Tp& lo, const _Tp& hi, Callback callback) const {
+	std::pair<const BNode<_Tp>*, uint32_t> stack[_BTREE_MAX_DEPTH];
+	uint32_t depth = 0;
+	uint64_t count = 0;
+
+	for (const BNode<_Tp>* curr = root; ; curr = curr->child[stack[depth - 1].second]) {
+		stack[depth++] = std::make_pair(curr, findIndex(curr, lo));
+		if (curr->leaf) {
+			break;
+		}
+	}
+
+	while (depth) {
+		std::pair<const BNode<_Tp>*, uint32_t>& top = stack[depth - 1];
+		const BNode<_Tp>* curr = top.first;
+
+		if (curr->leaf) {
+			if (depth > 1 and stack[depth - 2].second < stack[depth - 2].first->size) {
+				__builtin_prefetch(stack[depth - 2].first->child[stack[depth - 2].second + 1]);
+			}
+
+			for (uint32_t i = top.second; i < curr->size; i++) {
+				if (lessThan(hi, curr->key[i])) {
+					return count;
+				}
+
+				callback(curr->key[i]);
+				count++;
+			}
+
+			depth--;
+		}
+
+		else if (top.second == curr->size) {
+			depth--;
+		}
+
+		else {
+			if (lessThan(hi, curr->key[top.second])) {
+				return count;
+			}
+
+			callback(curr->key[top.second]);
+			count++;
+
+			for (curr = curr->child[++top.second]; ; curr = curr->child[0]) {
+				stack[depth++] = std::make_pair(curr, 0);
+				if (curr->leaf) {
+					break;
+				}
+			}
+		}
+	}
+
+	return count;
+}
+
+template <typename _Tp, class Cmp, class KT>
+std::ostream& operator<<(std::ostream& out, const BTree<_Tp, Cmp, KT>& btree) {
 	if (btree.printKey != nullptr and btree.root->size > 0) {
 		out << std::endl;
 		btree.printNode(out, btree.root, 0);
@@ -0,0 +1,901 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include "nodepool.hpp"
+
+#ifndef _CONCURRENTBTREE_OBSOLETE
+	#define _CONCURRENTBTREE_OBSOLETE 1
+#endif
+
+#ifndef _CONCURRENTBTREE_LOCKED
+	#define _CONCURRENTBTREE_LOCKED 2
+#endif
+
+#ifndef _CONCURRENTBTREE_NODE_ALIGNMENT
+	#define _CONCURRENTBTREE_NODE_ALIGNMENT 64
+#endif
+
+#ifndef _CONCURRENTBTREE_MAX_DEPTH
+	#define _CONCURRENTBTREE_MAX_DEPTH 32
+#endif
+
+#ifndef _CONCURRENTBTREE_EPOCH_STRIPES
+	#define _CONCURRENTBTREE_EPOCH_STRIPES 16
+#endif
+
+#ifndef _CONCURRENTBTREE_RECLAIM_BATCH
+	#define _CONCURRENTBTREE_RECLAIM_BATCH 64
+#endif
+
+template <typename _Tp>
+class ConcurrentBNode {
+	private:
+		std::atomic<uint64_t> version;
+		ConcurrentBNode** child;
+		_Tp* key;
+		uint32_t size;
+		bool leaf;
+
+		ConcurrentBNode* nextRetired;
+		uint64_t retireEpoch;
+
+		template <typename, class> friend class ConcurrentBTree;
+
+		static constexpr uint64_t keyOffset(void) noexcept;
+
+		static uint64_t childOffset(const uint32_t) noexcept;
+
+		ConcurrentBNode(const uint32_t, const bool) noexcept;
+
+		~ConcurrentBNode(void) = default;
+
+	public:
+		static uint64_t blockSize(const uint32_t, const bool) noexcept;
+
+		static ConcurrentBNode* create(void*, const uint32_t, const bool) noexcept;
+
+		static void destroy(ConcurrentBNode*, const uint32_t) noexcept;
+};
+
+template <typename _Tp, class Compare = std::less<_Tp>>
+class ConcurrentBTree {
+	private:
+		using Node = ConcurrentBNode<_Tp>;
+
+		struct alignas(64) EpochStripe {
+			std::atomic<uint64_t> active[3];
+			std::atomic<int64_t> keys;
+		};
+
+		class EpochGuard {
+			private:
+				EpochStripe& stripe;
+				const uint64_t epoch;
+
+			public:
+				explicit EpochGuard(const ConcurrentBTree&) noexcept;
+
+				EpochGuard(const EpochGuard&) = delete;
+
+				EpochGuard& operator=(const EpochGuard&) = delete;
+
+				~EpochGuard(void);
+		};
+
+		std::atomic<Node*> root;
+		const uint32_t minDegree;
+
+		Compare lessThan;
+
+		std::atomic<uint32_t> heightCount;
+		std::atomic<uint64_t> nodeBytes;
+
+		mutable EpochStripe stripes[_CONCURRENTBTREE_EPOCH_STRIPES];
+		std::atomic<uint64_t> globalEpoch;
+
+		std::mutex retireLock;
+		Node* retired;
+		uint64_t retiredCount;
+
+		NodePool leafPool;
+		NodePool internalPool;
+
+		static uint32_t stripeIndex(void) noexcept;
+
+		uint64_t enterEpoch(EpochStripe&) const noexcept;
+
+		void retireNode(Node*) noexcept;
+
+		void reclaim(void) noexcept;
+
+		static bool readVersion(const Node*, uint64_t&) noexcept;
+
+		static bool validate(const Node*, const uint64_t) noexcept;
+
+		static bool upgrade(Node*, const uint64_t) noexcept;
+
+		static bool tryLock(Node*) noexcept;
+
+		static void unlock(Node*) noexcept;
+
+		static void unlockObsolete(Node*) noexcept;
+
+		Node* allocateNode(const bool);
+
+		void releaseNode(Node*) noexcept;
+
+		void freeNode(Node*) noexcept;
+
+		bool equal(const _Tp&, const _Tp&) const noexcept;
+
+		uint32_t findIndex(const Node*, const _Tp&) const noexcept;
+
+		void nodeInsert(Node*, const _Tp&) noexcept;
+
+		_Tp nodeDelete(Node*, uint32_t) noexcept;
+
+		void splitChild(Node*, const uint32_t) noexcept;
+
+		void mergeChildren(Node*, const uint32_t) noexcept;
+
+		void fixChildSize(Node*, const uint64_t, const uint32_t, Node*, const uint64_t) noexcept;
+
+		bool lookupOnce(const _Tp&, std::optional<_Tp>&) const noexcept;
+
+		bool insertOnce(const _Tp&) noexcept;
+
+		bool removeOnce(const _Tp&, std::optional<_Tp>&) noexcept;
+
+		bool replaceSeparator(Node*, const uint64_t, const uint32_t, Node*, const uint64_t, const bool, std::optional<_Tp>&) noexcept;
+
+	public:
+		explicit ConcurrentBTree(const uint32_t, const Compare& = Compare(), std::pmr::memory_resource* = std::pmr::get_default_resource());
+
+		ConcurrentBTree(const ConcurrentBTree&) = delete;
+
+		ConcurrentBTree& operator=(const ConcurrentBTree&) = delete;
+
+		~ConcurrentBTree(void);
+
+		uint64_t num_keys(void) const noexcept;
+
+		uint32_t height(void) const noexcept;
+
+		uint64_t memory_in_bytes(void) const noexcept;
+
+		void insert(const _Tp) noexcept;
+
+		std::optional<_Tp> try_remove(const _Tp) noexcept;
+
+		std::optional<_Tp> find(const _Tp) const noexcept;
+
+		bool contains(const _Tp) const noexcept;
+};
+
+template <typename _Tp>
+constexpr uint64_t ConcurrentBNode<_Tp>::keyOffset(void) noexcept {
+	return (sizeof(ConcurrentBNode) + alignof(_Tp) - 1) / alignof(_Tp) * alignof(_Tp);
+}
+
+template <typename _Tp>
+uint64_t ConcurrentBNode<_Tp>::childOffset(const uint32_t minDegree) noexcept {
+	const uint64_t keysEnd = keyOffset() + (2 * minDegree - 1) * sizeof(_Tp);
+	return (keysEnd + alignof(ConcurrentBNode*) - 1) / alignof(ConcurrentBNode*) * alignof(ConcurrentBNode*);
+}
+
+template <typename _Tp>
+uint64_t ConcurrentBNode<_Tp>::blockSize(const uint32_t minDegree, const bool leaf) noexcept {
+	const uint64_t bytes = leaf ? keyOffset() + (2 * minDegree - 1) * sizeof(_Tp) : childOffset(minDegree) + 2 * minDegree * sizeof(ConcurrentBNode*);
+	return (bytes + _CONCURRENTBTREE_NODE_ALIGNMENT - 1) / _CONCURRENTBTREE_NODE_ALIGNMENT * _CONCURRENTBTREE_NODE_ALIGNMENT;
+}
+
+template <typename _Tp>
+ConcurrentBNode<_Tp>::ConcurrentBNode(const uint32_t minDegree, const bool isLeaf) noexcept
+	: version(0), child(nullptr), size(0), leaf(isLeaf), nextRetired(nullptr), retireEpoch(0) {
+	key = reinterpret_cast<_Tp*>(reinterpret_cast<char*>(this) + keyOffset());
+	for (uint32_t i = 0; i < 2 * minDegree - 1; i++) {
+		new (key + i) _Tp();
+	}
+
+	if (not leaf) {
+		child = reinterpret_cast<ConcurrentBNode**>(reinterpret_cast<char*>(this) + childOffset(minDegree));
+		for (uint32_t i = 0; i < 2 * minDegree; i++) {
+			child[i] = nullptr;
+		}
+	}
+}
+
+template <typename _Tp>
+ConcurrentBNode<_Tp>* ConcurrentBNode<_Tp>::create(void* block, const uint32_t minDegree, const bool leaf) noexcept {
+	return new (block) ConcurrentBNode(minDegree, leaf);
+}
+
+template <typename _Tp>
+void ConcurrentBNode<_Tp>::destroy(ConcurrentBNode* node, const uint32_t minDegree) noexcept {
+	for (uint32_t i = 0; i < 2 * minDegree - 1; i++) {
+		node->key[i].~_Tp();
+	}
+
+	node->~ConcurrentBNode();
+}
+
+template <typename _Tp, class Cmp>
+ConcurrentBTree<_Tp, Cmp>::EpochGuard::EpochGuard(const ConcurrentBTree& owner) noexcept
+	: stripe(owner.stripes[stripeIndex()]), epoch(owner.enterEpoch(stripe)) {}
+
+template <typename _Tp, class Cmp>
+ConcurrentBTree<_Tp, Cmp>::EpochGuard::~EpochGuard(void) {
+	stripe.active[epoch % 3].fetch_sub(1, std::memory_order_release);
+}
+
+template <typename _Tp, class Cmp>
+ConcurrentBTree<_Tp, Cmp>::ConcurrentBTree(const uint32_t deg, const Cmp& compare, std::pmr::memory_resource* upstream)
+	: minDegree(deg), lessThan(compare), heightCount(0), nodeBytes(0), globalEpoch(0), retired(nullptr), retiredCount(0),
+	leafPool(Node::blockSize(deg, true), _CONCURRENTBTREE_NODE_ALIGNMENT, upstream), internalPool(Node::blockSize(deg, false), _CONCURRENTBTREE_NODE_ALIGNMENT, upstream) {
+	static_assert(std::is_trivially_copyable<_Tp>::value, "optimistic readers copy keys that may be overwritten concurrently");
+
+	for (EpochStripe& stripe : stripes) {
+		for (std::atomic<uint64_t>& active : stripe.active) {
+			active.store(0, std::memory_order_relaxed);
+		}
+
+		stripe.keys.store(0, std::memory_order_relaxed);
+	}
+
+	root.store(allocateNode(true), std::memory_order_release);
+}
+
+template <typename _Tp, class Cmp>
+ConcurrentBTree<_Tp, Cmp>::~ConcurrentBTree(void) {
+	freeNode(root.load(std::memory_order_acquire));
+
+	while (retired) {
+		Node* next = retired->nextRetired;
+		releaseNode(retired);
+		retired = next;
+	}
+}
+
+template <typename _Tp, class Cmp>
+uint32_t ConcurrentBTree<_Tp, Cmp>::stripeIndex(void) noexcept {
+	static std::atomic<uint32_t> nextStripe{0};
+	thread_local const uint32_t stripe = nextStripe++ % _CONCURRENTBTREE_EPOCH_STRIPES;
+	return stripe;
+}
+
+template <typename _Tp, class Cmp>
+uint64_t ConcurrentBTree<_Tp, Cmp>::enterEpoch(EpochStripe& stripe) const noexcept {
+	while (true) {
+		const uint64_t epoch = globalEpoch.load();
+		stripe.active[epoch % 3].fetch_add(1);
+
+		if (globalEpoch.load() == epoch) {
+			return epoch;
+		}
+
+		stripe.active[epoch % 3].fetch_sub(1, std::memory_order_release);
+	}
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::retireNode(Node* node) noexcept {
+	std::lock_guard<std::mutex> guard(retireLock);
+	node->retireEpoch = globalEpoch.load();
+	node->nextRetired = retired;
+	retired = node;
+
+	if (++ retiredCount >= _CONCURRENTBTREE_RECLAIM_BATCH) {
+		reclaim();
+	}
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::reclaim(void) noexcept {
+	uint64_t epoch = globalEpoch.load();
+
+	bool quiet = true;
+	for (const EpochStripe& stripe : stripes) {
+		quiet = quiet and not stripe.active[(epoch + 2) % 3].load();
+	}
+
+	if (quiet and globalEpoch.compare_exchange_strong(epoch, epoch + 1)) {
+		epoch++;
+	}
+
+	Node** link = &retired;
+	while (*link) {
+		Node* node = *link;
+		if (node->retireEpoch + 2 <= epoch) {
+			*link = node->nextRetired;
+			releaseNode(node);
+			retiredCount--;
+		}
+
+		else {
+			link = &node->nextRetired;
+		}
+	}
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::readVersion(const Node* node, uint64_t& version) noexcept {
+	version = node->version.load(std::memory_order_acquire);
+	while (version & _CONCURRENTBTREE_LOCKED) {
+		std::this_thread::yield();
+		version = node->version.load(std::memory_order_acquire);
+	}
+
+	return not (version & _CONCURRENTBTREE_OBSOLETE);
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::validate(const Node* node, const uint64_t version) noexcept {
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return node->version.load(std::memory_order_relaxed) == version;
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::upgrade(Node* node, const uint64_t version) noexcept {
+	uint64_t expected = version;
+	return node->version.compare_exchange_strong(expected, version + _CONCURRENTBTREE_LOCKED, std::memory_order_acquire);
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::tryLock(Node* node) noexcept {
+	const uint64_t version = node->version.load(std::memory_order_acquire);
+	if (version & (_CONCURRENTBTREE_LOCKED bitor _CONCURRENTBTREE_OBSOLETE)) {
+		return false;
+	}
+
+	return upgrade(node, version);
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::unlock(Node* node) noexcept {
+	node->version.fetch_add(_CONCURRENTBTREE_LOCKED, std::memory_order_release);
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::unlockObsolete(Node* node) noexcept {
+	node->version.fetch_add(_CONCURRENTBTREE_LOCKED + _CONCURRENTBTREE_OBSOLETE, std::memory_order_release);
+}
+
+template <typename _Tp, class Cmp>
+ConcurrentBNode<_Tp>* ConcurrentBTree<_Tp, Cmp>::allocateNode(const bool leaf) {
+	NodePool& pool = leaf ? leafPool : internalPool;
+	nodeBytes.fetch_add(pool.block_size(), std::memory_order_relaxed);
+	return Node::create(pool.allocate_block(), minDegree, leaf);
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::releaseNode(Node* node) noexcept {
+	NodePool& pool = node->leaf ? leafPool : internalPool;
+	nodeBytes.fetch_sub(pool.block_size(), std::memory_order_relaxed);
+	Node::destroy(node, minDegree);
+	pool.release_block(node);
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::freeNode(Node* node) noexcept {
+	if (not node->leaf) {
+		for (uint32_t i = 0; i <= node->size; i++) {
+			freeNode(node->child[i]);
+		}
+	}
+
+	releaseNode(node);
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::equal(const _Tp& a, const _Tp& b) const noexcept {
+	return not lessThan(a, b) and not lessThan(b, a);
+}
+
+template <typename _Tp, class Cmp>
+uint32_t ConcurrentBTree<_Tp, Cmp>::findIndex(const Node* node, const _Tp& key) const noexcept {
+	const uint32_t size = std::min(node->size, 2 * minDegree - 1);
+	if (size == 0) {
+		return 0;
+	}
+
+	const _Tp* base = node->key;
+	for (uint32_t n = size; n > 1; ) {
+		const uint32_t half = n / 2;
+		base = lessThan(base[half], key) ? base + half : base;
+		n -= half;
+	}
+
+	return (base - node->key) + lessThan(*base, key);
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::nodeInsert(Node* node, const _Tp& key) noexcept {
+	uint32_t index;
+	for (index = node->size; index > 0 and lessThan(key, node->key[index - 1]); index--) {
+		node->key[index] = node->key[index - 1];
+	}
+
+	node->key[index] = key;
+	node->size++;
+}
+
+template <typename _Tp, class Cmp>
+_Tp ConcurrentBTree<_Tp, Cmp>::nodeDelete(Node* node, uint32_t index) noexcept {
+	_Tp toReturn = node->key[index];
+	node->size--;
+
+	while (index < node->size) {
+		node->key[index] = node->key[index + 1];
+		if (not node->leaf) {
+			node->child[index + 1] = node->child[index + 2];
+		}
+		index++;
+	}
+
+	return toReturn;
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::splitChild(Node* par, const uint32_t index) noexcept {
+	Node* toSplit = par->child[index];
+	Node* newNode = allocateNode(toSplit->leaf);
+	newNode->size = minDegree - 1;
+
+	for (uint32_t j = 0; j < minDegree - 1; j++) {
+		newNode->key[j] = toSplit->key[j + minDegree];
+	}
+
+	if (not toSplit->leaf) {
+		for (uint32_t j = 0; j < minDegree; j++)
+			newNode->child[j] = toSplit->child[j + minDegree];
+	}
+	toSplit->size = minDegree - 1;
+
+	for (uint32_t j = par->size; j > index; j--) {
+		par->key[j] = par->key[j - 1];
+		par->child[j + 1] = par->child[j];
+	}
+
+	par->key[index] = toSplit->key[minDegree - 1];
+	par->child[index + 1] = newNode;
+	par->size++;
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::mergeChildren(Node* par, const uint32_t index) noexcept {
+	Node* leftChild = par->child[index];
+	Node* rightChild = par->child[index + 1];
+
+	leftChild->key[leftChild->size] = nodeDelete(par, index);
+	uint32_t j = ++ leftChild->size;
+
+	for (uint32_t k = 0; k < rightChild->size; k++) {
+		leftChild->key[j + k] = rightChild->key[k];
+		if (not leftChild->leaf) {
+			leftChild->child[j + k] = rightChild->child[k];
+		}
+	}
+	leftChild->size += rightChild->size;
+	if (not leftChild->leaf) {
+		leftChild->child[leftChild->size] = rightChild->child[rightChild->size];
+	}
+
+	unlockObsolete(rightChild);
+	retireNode(rightChild);
+
+	if (par->size == 0) {
+		root.store(leftChild, std::memory_order_release);
+		heightCount.fetch_sub(1, std::memory_order_relaxed);
+		unlockObsolete(par);
+		retireNode(par);
+	}
+
+	else {
+		unlock(par);
+	}
+
+	unlock(leftChild);
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::fixChildSize(Node* par, const uint64_t parVersion, const uint32_t index, Node* child, const uint64_t childVersion) noexcept {
+	if (not upgrade(par, parVersion)) {
+		return;
+	}
+
+	if (not upgrade(child, childVersion)) {
+		unlock(par);
+		return;
+	}
+
+	Node* leftSibling = index > 0 ? par->child[index - 1] : nullptr;
+	if (leftSibling and not tryLock(leftSibling)) {
+		unlock(child);
+		unlock(par);
+		return;
+	}
+
+	Node* rightSibling = nullptr;
+	if (index < par->size and not (leftSibling and leftSibling->size >= minDegree)) {
+		rightSibling = par->child[index + 1];
+		if (not tryLock(rightSibling)) {
+			if (leftSibling) {
+				unlock(leftSibling);
+			}
+
+			unlock(child);
+			unlock(par);
+			return;
+		}
+	}
+
+	if (leftSibling and leftSibling->size >= minDegree) {
+		for (uint32_t j = child->size; j > 0; j--) {
+			child->key[j] = child->key[j - 1];
+		}
+
+		if (not child->leaf) {
+			for (uint32_t j = child->size + 1; j > 0; j--) {
+				child->child[j] = child->child[j - 1];
+			}
+
+			child->child[0] = leftSibling->child[leftSibling->size];
+		}
+
+		child->key[0] = par->key[index - 1];
+		child->size++;
+		par->key[index - 1] = leftSibling->key[-- leftSibling->size];
+	}
+
+	else if (rightSibling and rightSibling->size >= minDegree) {
+		child->key[child->size] = par->key[index];
+		if (not child->leaf) {
+			child->child[child->size + 1] = rightSibling->child[0];
+			rightSibling->child[0] = rightSibling->child[1];
+		}
+		child->size++;
+		par->key[index] = nodeDelete(rightSibling, 0);
+	}
+
+	else if (leftSibling) {
+		if (rightSibling) {
+			unlock(rightSibling);
+		}
+
+		mergeChildren(par, index - 1);
+		return;
+	}
+
+	else {
+		mergeChildren(par, index);
+		return;
+	}
+
+	if (leftSibling) {
+		unlock(leftSibling);
+	}
+
+	if (rightSibling) {
+		unlock(rightSibling);
+	}
+
+	unlock(child);
+	unlock(par);
+}
+
+template <typename _Tp, class Cmp>
+uint64_t ConcurrentBTree<_Tp, Cmp>::num_keys(void) const noexcept {
+	int64_t keys = 0;
+	for (const EpochStripe& stripe : stripes) {
+		keys += stripe.keys.load(std::memory_order_relaxed);
+	}
+
+	return std::max<int64_t>(0, keys);
+}
+
+template <typename _Tp, class Cmp>
+uint32_t ConcurrentBTree<_Tp, Cmp>::height(void) const noexcept {
+	return heightCount.load(std::memory_order_relaxed);
+}
+
+template <typename _Tp, class Cmp>
+uint64_t ConcurrentBTree<_Tp, Cmp>::memory_in_bytes(void) const noexcept {
+	return nodeBytes.load(std::memory_order_relaxed);
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::lookupOnce(const _Tp& key, std::optional<_Tp>& result) const noexcept {
+	const Node* node = root.load(std::memory_order_acquire);
+	uint64_t version;
+	if (not readVersion(node, version) or node != root.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	while (true) {
+		const uint32_t i = findIndex(node, key);
+		const _Tp found = node->key[std::min(i, 2 * minDegree - 2)];
+
+		if (i < node->size and equal(found, key)) {
+			if (not validate(node, version)) {
+				return false;
+			}
+
+			result = found;
+			return true;
+		}
+
+		if (node->leaf) {
+			if (not validate(node, version)) {
+				return false;
+			}
+
+			result = std::nullopt;
+			return true;
+		}
+
+		const Node* next = node->child[i];
+		if (not validate(node, version)) {
+			return false;
+		}
+
+		uint64_t nextVersion;
+		if (not readVersion(next, nextVersion) or not validate(node, version)) {
+			return false;
+		}
+
+		node = next;
+		version = nextVersion;
+	}
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::insertOnce(const _Tp& key) noexcept {
+	Node* node = root.load(std::memory_order_acquire);
+	uint64_t version;
+	if (not readVersion(node, version) or node != root.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	if (node->size == 2 * minDegree - 1) {
+		if (not upgrade(node, version)) {
+			return false;
+		}
+
+		Node* newRoot = allocateNode(false);
+		newRoot->child[0] = node;
+		splitChild(newRoot, 0);
+		root.store(newRoot, std::memory_order_release);
+		heightCount.fetch_add(1, std::memory_order_relaxed);
+		unlock(node);
+		return false;
+	}
+
+	while (not node->leaf) {
+		const uint32_t index = findIndex(node, key);
+		Node* next = node->child[index];
+		if (not validate(node, version)) {
+			return false;
+		}
+
+		uint64_t nextVersion;
+		if (not readVersion(next, nextVersion)) {
+			return false;
+		}
+
+		if (next->size == 2 * minDegree - 1) {
+			if (not upgrade(node, version)) {
+				return false;
+			}
+
+			if (not upgrade(next, nextVersion)) {
+				unlock(node);
+				return false;
+			}
+
+			splitChild(node, index);
+			unlock(next);
+			unlock(node);
+			return false;
+		}
+
+		if (not validate(node, version)) {
+			return false;
+		}
+
+		node = next;
+		version = nextVersion;
+	}
+
+	if (not upgrade(node, version)) {
+		return false;
+	}
+
+	nodeInsert(node, key);
+	unlock(node);
+	return true;
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::replaceSeparator(Node* node, const uint64_t version, const uint32_t index, Node* subtree, const uint64_t subtreeVersion,
+	const bool predecessor, std::optional<_Tp>& removed) noexcept {
+	std::pair<Node*, uint64_t> path[_CONCURRENTBTREE_MAX_DEPTH];
+	uint32_t depth = 0;
+
+	Node* curr = subtree;
+	uint64_t currVersion = subtreeVersion;
+
+	while (not curr->leaf) {
+		const uint32_t i = predecessor ? std::min(curr->size, 2 * minDegree - 1) : 0;
+		Node* next = curr->child[i];
+		if (not validate(curr, currVersion)) {
+			return false;
+		}
+
+		uint64_t nextVersion;
+		if (not readVersion(next, nextVersion)) {
+			return false;
+		}
+
+		if (next->size < minDegree) {
+			fixChildSize(curr, currVersion, i, next, nextVersion);
+			return false;
+		}
+
+		if (not validate(curr, currVersion)) {
+			return false;
+		}
+
+		path[depth++] = std::make_pair(curr, currVersion);
+		curr = next;
+		currVersion = nextVersion;
+	}
+
+	if (not upgrade(node, version)) {
+		return false;
+	}
+
+	if (not upgrade(curr, currVersion)) {
+		unlock(node);
+		return false;
+	}
+
+	for (uint32_t d = 0; d < depth; d++) {
+		if (not validate(path[d].first, path[d].second)) {
+			unlock(curr);
+			unlock(node);
+			return false;
+		}
+	}
+
+	removed = node->key[index];
+	node->key[index] = nodeDelete(curr, predecessor ? curr->size - 1 : 0);
+	unlock(curr);
+	unlock(node);
+	return true;
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::removeOnce(const _Tp& key, std::optional<_Tp>& removed) noexcept {
+	Node* node = root.load(std::memory_order_acquire);
+	uint64_t version;
+	if (not readVersion(node, version) or node != root.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	while (true) {
+		const uint32_t i = findIndex(node, key);
+		const bool found = i < node->size and equal(node->key[std::min(i, 2 * minDegree - 2)], key);
+
+		if (node->leaf) {
+			if (not found) {
+				removed = std::nullopt;
+				return validate(node, version);
+			}
+
+			if (not upgrade(node, version)) {
+				return false;
+			}
+
+			removed = nodeDelete(node, i);
+			unlock(node);
+			return true;
+		}
+
+		Node* next = node->child[i];
+		Node* sibling = found ? node->child[i + 1] : nullptr;
+		if (not validate(node, version)) {
+			return false;
+		}
+
+		uint64_t nextVersion, siblingVersion = 0;
+		if (not readVersion(next, nextVersion) or (sibling and not readVersion(sibling, siblingVersion))) {
+			return false;
+		}
+
+		const uint32_t nextSize = next->size;
+		const uint32_t siblingSize = sibling ? sibling->size : 0;
+		if (not validate(node, version)) {
+			return false;
+		}
+
+		if (found) {
+			if (nextSize >= minDegree) {
+				return replaceSeparator(node, version, i, next, nextVersion, true, removed);
+			}
+
+			if (siblingSize >= minDegree) {
+				return replaceSeparator(node, version, i, sibling, siblingVersion, false, removed);
+			}
+
+			if (upgrade(node, version)) {
+				if (not upgrade(next, nextVersion)) {
+					unlock(node);
+				}
+
+				else if (not upgrade(sibling, siblingVersion)) {
+					unlock(next);
+					unlock(node);
+				}
+
+				else {
+					mergeChildren(node, i);
+				}
+			}
+
+			return false;
+		}
+
+		if (nextSize < minDegree) {
+			fixChildSize(node, version, i, next, nextVersion);
+			return false;
+		}
+
+		node = next;
+		version = nextVersion;
+	}
+}
+
+template <typename _Tp, class Cmp>
+void ConcurrentBTree<_Tp, Cmp>::insert(const _Tp key) noexcept {
+	EpochGuard guard(*this);
+	while (not insertOnce(key)) {}
+
+	stripes[stripeIndex()].keys.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename _Tp, class Cmp>
+std::optional<_Tp> ConcurrentBTree<_Tp, Cmp>::try_remove(const _Tp key) noexcept {
+	EpochGuard guard(*this);
+	std::optional<_Tp> removed;
+	while (not removeOnce(key, removed)) {}
+
+	if (removed) {
+		stripes[stripeIndex()].keys.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	return removed;
+}
+
+template <typename _Tp, class Cmp>
+std::optional<_Tp> ConcurrentBTree<_Tp, Cmp>::find(const _Tp key) const noexcept {
+	EpochGuard guard(*this);
+	std::optional<_Tp> result;
+	while (not lookupOnce(key, result)) {}
+
+	return result;
+}
+
+template <typename _Tp, class Cmp>
+bool ConcurrentBTree<_Tp, Cmp>::contains(const _Tp key) const noexcept {
+	return find(key).has_value();
+}
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <new>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <memory_resource>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#endif
+
+#ifndef _FROZENBTREE_BLOCK_BYTES
+	#define _FROZENBTREE_BLOCK_BYTES 64
+#endif
+
+#ifndef _FROZENBTREE_BATCH
+	#define _FROZENBTREE_BATCH 16
+#endif
+
+template <typename _Tp, class Compare = std::less<_Tp>>
+class FrozenBTree {
+	private:
+		static constexpr uint32_t blockKeys = std::max<size_t>(1, _FROZENBTREE_BLOCK_BYTES / sizeof(_Tp));
+
+		_Tp* keys;
+		uint64_t keyCount;
+		uint64_t blockCount;
+		uint32_t heightCount;
+
+		Compare lessThan;
+		std::pmr::memory_resource* upstream;
+
+		static uint64_t childBlock(const uint64_t, const uint32_t) noexcept;
+
+		void release(void) noexcept;
+
+		template <class Iterator>
+		void build(Iterator&, const uint64_t, uint64_t&, uint64_t&);
+
+		uint32_t rank(const _Tp*, const _Tp&) const noexcept;
+
+		const _Tp* lowerBound(const _Tp&) const noexcept;
+
+		template <class Visit>
+		void batch(const _Tp*, const size_t, Visit) const noexcept;
+
+	public:
+		template <class Iterator>
+		FrozenBTree(Iterator, Iterator, const Compare& = Compare(), std::pmr::memory_resource* = std::pmr::get_default_resource());
+
+		FrozenBTree(const FrozenBTree&) = delete;
+
+		FrozenBTree& operator=(const FrozenBTree&) = delete;
+
+		FrozenBTree(FrozenBTree&&) noexcept;
+
+		FrozenBTree& operator=(FrozenBTree&&) noexcept;
+
+		~FrozenBTree(void);
+
+		uint64_t num_keys(void) const noexcept;
+
+		uint32_t height(void) const noexcept;
+
+		uint64_t memory_in_bytes(void) const noexcept;
+
+		std::optional<_Tp> lower_bound(const _Tp&) const noexcept;
+
+		std::optional<_Tp> find(const _Tp) const noexcept;
+
+		bool contains(const _Tp) const noexcept;
+
+		void lower_bound_batch(const _Tp*, const size_t, std::optional<_Tp>*) const noexcept;
+
+		uint64_t contains_batch(const _Tp*, const size_t, bool*) const noexcept;
+};
+
+template <typename _Tp, class Cmp>
+template <class Iterator>
+FrozenBTree<_Tp, Cmp>::FrozenBTree(Iterator first, Iterator last, const Cmp& compare, std::pmr::memory_resource* resource)
+	: keys(nullptr), keyCount(std::distance(first, last)), blockCount(0), heightCount(0), lessThan(compare), upstream(resource) {
+	if (first != last) {
+		for (Iterator prev = first, curr = std::next(first); curr != last; prev = curr++) {
+			if (lessThan(*curr, *prev)) {
+				throw std::invalid_argument("_FROZENBTREE_UNSORTED_INPUT");
+			}
+		}
+	}
+
+	blockCount = (keyCount + blockKeys - 1) / blockKeys;
+	for (uint64_t reach = 0; reach < blockCount; reach = reach * (blockKeys + 1) + 1) {
+		heightCount++;
+	}
+
+	if (not blockCount) {
+		return;
+	}
+
+	keys = (_Tp*) upstream->allocate(blockCount * blockKeys * sizeof(_Tp), std::max<size_t>(_FROZENBTREE_BLOCK_BYTES, alignof(_Tp)));
+
+	uint64_t placed = 0, lastSlot = 0;
+	build(first, 0, placed, lastSlot);
+}
+
+template <typename _Tp, class Cmp>
+FrozenBTree<_Tp, Cmp>::FrozenBTree(FrozenBTree&& other) noexcept
+	: keys(other.keys), keyCount(other.keyCount), blockCount(other.blockCount), heightCount(other.heightCount), lessThan(std::move(other.lessThan)), upstream(other.upstream) {
+	other.keys = nullptr;
+	other.keyCount = other.blockCount = 0;
+	other.heightCount = 0;
+}
+
+template <typename _Tp, class Cmp>
+FrozenBTree<_Tp, Cmp>& FrozenBTree<_Tp, Cmp>::operator=(FrozenBTree&& other) noexcept {
+	if (this == &other) {
+		return *this;
+	}
+
+	release();
+
+	keys = other.keys;
+	keyCount = other.keyCount;
+	blockCount = other.blockCount;
+	heightCount = other.heightCount;
+	lessThan = std::move(other.lessThan);
+	upstream = other.upstream;
+
+	other.keys = nullptr;
+	other.keyCount = other.blockCount = 0;
+	other.heightCount = 0;
+	return *this;
+}
+
+template <typename _Tp, class Cmp>
+FrozenBTree<_Tp, Cmp>::~FrozenBTree(void) {
+	release();
+}
+
+template <typename _Tp, class Cmp>
+void FrozenBTree<_Tp, Cmp>::release(void) noexcept {
+	if (not keys) {
+		return;
+	}
+
+	for (uint64_t i = 0; i < blockCount * blockKeys; i++) {
+		keys[i].~_Tp();
+	}
+
+	upstream->deallocate(keys, blockCount * blockKeys * sizeof(_Tp), std::max<size_t>(_FROZENBTREE_BLOCK_BYTES, alignof(_Tp)));
+}
+
+template <typename _Tp, class Cmp>
+uint64_t FrozenBTree<_Tp, Cmp>::childBlock(const uint64_t block, const uint32_t index) noexcept {
+	return block * (blockKeys + 1) + index + 1;
+}
+
+template <typename _Tp, class Cmp>
+template <class Iterator>
+void FrozenBTree<_Tp, Cmp>::build(Iterator& it, const uint64_t block, uint64_t& placed, uint64_t& lastSlot) {
+	if (block >= blockCount) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < blockKeys; i++) {
+		build(it, childBlock(block, i), placed, lastSlot);
+
+		const uint64_t slot = block * blockKeys + i;
+		if (placed < keyCount) {
+			new (keys + slot) _Tp(*it);
+			++it;
+			placed++;
+			lastSlot = slot;
+		}
+
+		else {
+			new (keys + slot) _Tp(keys[lastSlot]);
+		}
+	}
+
+	build(it, childBlock(block, blockKeys), placed, lastSlot);
+}
+
+template <typename _Tp, class Cmp>
+uint32_t FrozenBTree<_Tp, Cmp>::rank(const _Tp* block, const _Tp& key) const noexcept {
+#if defined(__AVX2__)
+	if constexpr (std::is_integral<_Tp>::value and std::is_same<Cmp, std::less<_Tp>>::value and blockKeys * sizeof(_Tp) % 32 == 0) {
+		const _Tp bias = std::is_signed<_Tp>::value ? _Tp(0) : _Tp(_Tp(1) << (8 * sizeof(_Tp) - 1));
+		uint32_t count = 0;
+
+		if constexpr (sizeof(_Tp) == 4) {
+			const __m256i flip = _mm256_set1_epi32(int32_t(bias));
+			const __m256i needle = _mm256_xor_si256(_mm256_set1_epi32(int32_t(key)), flip);
+
+			for (uint32_t i = 0; i < blockKeys; i += 8) {
+				__m256i lane = _mm256_xor_si256(_mm256_load_si256((const __m256i*) (block + i)), flip);
+				count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, lane))));
+			}
+
+			return count;
+		}
+
+		else if constexpr (sizeof(_Tp) == 8) {
+			const __m256i flip = _mm256_set1_epi64x(int64_t(bias));
+			const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(int64_t(key)), flip);
+
+			for (uint32_t i = 0; i < blockKeys; i += 4) {
+				__m256i lane = _mm256_xor_si256(_mm256_load_si256((const __m256i*) (block + i)), flip);
+				count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, lane))));
+			}
+
+			return count;
+		}
+	}
+#endif
+
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < blockKeys; i++) {
+		count += lessThan(block[i], key);
+	}
+
+	return count;
+}
+
+template <typename _Tp, class Cmp>
+const _Tp* FrozenBTree<_Tp, Cmp>::lowerBound(const _Tp& key) const noexcept {
+	const _Tp* result = nullptr;
+
+	for (uint64_t block = 0; block < blockCount; ) {
+		const _Tp* base = keys + block * blockKeys;
+		const uint32_t i = rank(base, key);
+
+		if (i < blockKeys) {
+			result = base + i;
+		}
+
+		block = childBlock(block, i);
+	}
+
+	return result;
+}
+
+template <typename _Tp, class Cmp>
+template <class Visit>
+void FrozenBTree<_Tp, Cmp>::batch(const _Tp* probes, const size_t count, Visit visit) const noexcept {
+	uint64_t block[_FROZENBTREE_BATCH];
+	const _Tp* result[_FROZENBTREE_BATCH];
+
+	for (size_t first = 0; first < count; first += _FROZENBTREE_BATCH) {
+		const size_t width = std::min<size_t>(_FROZENBTREE_BATCH, count - first);
+		for (size_t j = 0; j < width; j++) {
+			block[j] = 0;
+			result[j] = nullptr;
+		}
+
+		for (uint32_t level = 0; level < heightCount; level++) {
+			for (size_t j = 0; j < width; j++) {
+				if (block[j] >= blockCount) {
+					continue;
+				}
+
+				const _Tp* base = keys + block[j] * blockKeys;
+				const uint32_t i = rank(base, probes[first + j]);
+
+				if (i < blockKeys) {
+					result[j] = base + i;
+				}
+
+				block[j] = childBlock(block[j], i);
+				if (block[j] < blockCount) {
+					__builtin_prefetch(keys + block[j] * blockKeys);
+				}
+			}
+		}
+
+		for (size_t j = 0; j < width; j++) {
+			visit(first + j, result[j]);
+		}
+	}
+}
+
+template <typename _Tp, class Cmp>
+uint64_t FrozenBTree<_Tp, Cmp>::num_keys(void) const noexcept {
+	return keyCount;
+}
+
+template <typename _Tp, class Cmp>
+uint32_t FrozenBTree<_Tp, Cmp>::height(void) const noexcept {
+	return heightCount;
+}
+
+template <typename _Tp, class Cmp>
+uint64_t FrozenBTree<_Tp, Cmp>::memory_in_bytes(void) const noexcept {
+	return blockCount * blockKeys * sizeof(_Tp);
+}
+
+template <typename _Tp, class Cmp>
+std::optional<_Tp> FrozenBTree<_Tp, Cmp>::lower_bound(const _Tp& key) const noexcept {
+	const _Tp* result = lowerBound(key);
+	if (result == nullptr) {
+		return std::nullopt;
+	}
+
+	return *result;
+}
+
+template <typename _Tp, class Cmp>
+std::optional<_Tp> FrozenBTree<_Tp, Cmp>::find(const _Tp key) const noexcept {
+	const _Tp* result = lowerBound(key);
+	if (result == nullptr or lessThan(key, *result)) {
+		return std::nullopt;
+	}
+
+	return *result;
+}
+
+template <typename _Tp, class Cmp>
+bool FrozenBTree<_Tp, Cmp>::contains(const _Tp key) const noexcept {
+	const _Tp* result = lowerBound(key);
+	return result != nullptr and not lessThan(key, *result);
+}
+
+template <typename _Tp, class Cmp>
+void FrozenBTree<_Tp, Cmp>::lower_bound_batch(const _Tp* probes, const size_t count, std::optional<_Tp>* out) const noexcept {
+	batch(probes, count, [&](const size_t j, const _Tp* result) {
+		if (result == nullptr) {
+			out[j] = std::nullopt;
+		}
+
+		else {
+			out[j] = *result;
+		}
+	});
+}
+
+template <typename _Tp, class Cmp>
+uint64_t FrozenBTree<_Tp, Cmp>::contains_batch(const _Tp* probes, const size_t count, bool* out) const noexcept {
+	uint64_t found = 0;
+	batch(probes, count, [&](const size_t j, const _Tp* result) {
+		out[j] = result != nullptr and not lessThan(probes[j], *result);
+		found += out[j];
+	});
+
+	return found;
+}
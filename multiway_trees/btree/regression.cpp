@@ -0,0 +1,170 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <set>
+#include "btree.hpp"
+#include "frozenbtree.hpp"
+using namespace std;
+
+void test_sequential_insert(void) {
+	BTree<int> tree(2);
+	for (int i = 0; i < 1000; i++) {
+		tree.insert(i);
+	}
+
+	assert(tree.num_keys() == 1000);
+	for (int i = 0; i < 1000; i++) {
+		assert(tree.searchKey(i) == i);
+	}
+
+	assert(tree.search(1000).first == nullptr);
+}
+
+void test_descending_insert(void) {
+	BTree<int> tree(2);
+	for (int i = 1000; i > 0; i--) {
+		tree.insert(i);
+	}
+
+	assert(tree.num_keys() == 1000);
+	for (int i = 1; i <= 1000; i++) {
+		assert(tree.searchKey(i) == i);
+	}
+}
+
+void test_shuffled_insert(void) {
+	vector<int> keys(5000);
+	for (int i = 0; i < 5000; i++) {
+		keys[i] = i;
+	}
+
+	mt19937 gen(1);
+	shuffle(keys.begin(), keys.end(), gen);
+
+	for (uint32_t deg : {2, 3, 16}) {
+		BTree<int> tree(deg);
+		for (int k : keys) {
+			tree.insert(k);
+		}
+
+		for (int k : keys) {
+			assert(tree.searchKey(k) == k);
+		}
+	}
+}
+
+void test_duplicate_split(void) {
+	vector<int> sorted;
+	for (int k = 0; k < 50; k++) {
+		for (int j = 0; j < 20; j++) {
+			sorted.push_back(k);
+		}
+	}
+
+	vector<int> extra = sorted;
+	mt19937 gen(7);
+	shuffle(extra.begin(), extra.end(), gen);
+
+	for (uint32_t deg : {2, 3, 4}) {
+		BTree<int> tree(deg);
+		tree.bulk_load(sorted.begin(), sorted.end());
+		for (int k : extra) {
+			tree.insert(k);
+		}
+
+		for (int k = 0; k < 50; k++) {
+			assert(tree.searchKey(k) == k);
+		}
+
+		for (int k : extra) {
+			tree.remove(k);
+			tree.remove(k);
+		}
+
+		for (int k = -1; k <= 50; k++) {
+			assert(tree.search(k).first == nullptr);
+		}
+	}
+}
+
+void test_remove(void) {
+	mt19937 gen(11);
+	for (int range : {7, 300}) {
+		for (uint32_t deg : {2, 3, 4, 16}) {
+			BTree<int> tree(deg);
+			multiset<int> expected;
+			for (int i = 0; i < 20000; i++) {
+				int k = gen() % range;
+				if (gen() % 3 == 0 and expected.count(k)) {
+					assert(tree.remove(k) == k);
+					expected.erase(expected.find(k));
+				}
+
+				else {
+					tree.insert(k);
+					expected.insert(k);
+				}
+
+				assert(tree.num_keys() == expected.size());
+			}
+
+			for (int k = 0; k < range; k++) {
+				assert((tree.search(k).first != nullptr) == (expected.count(k) > 0));
+			}
+		}
+	}
+}
+
+bool greater_than(const int& a, const int& b) {
+	return a > b;
+}
+
+void test_pointer_comparator(void) {
+	BTree tree(2, greater_than);
+	for (int i = 0; i < 100; i++) {
+		tree.insert(i);
+	}
+
+	int expected = 99;
+	for (int key : tree) {
+		assert(key == expected--);
+	}
+
+	assert(expected == -1 and not tree.contains(100));
+}
+
+void test_frozen_move(void) {
+	vector<int> sorted(1000);
+	for (int i = 0; i < 1000; i++) {
+		sorted[i] = 2 * i;
+	}
+
+	vector<FrozenBTree<int>> trees;
+	for (int i = 0; i < 4; i++) {
+		trees.emplace_back(sorted.begin(), sorted.begin() + 250 * (i + 1));
+	}
+
+	FrozenBTree<int> moved(move(trees[3]));
+	assert(trees[3].num_keys() == 0 and not trees[3].contains(0));
+	assert(moved.num_keys() == 1000 and moved.contains(1998) and not moved.contains(1999));
+
+	trees[0] = move(moved);
+	assert(moved.num_keys() == 0);
+	assert(trees[0].num_keys() == 1000 and trees[0].lower_bound(1001) == 1002);
+	assert(trees[1].num_keys() == 500 and not trees[1].contains(1000));
+}
+
+int main(void) {
+	test_sequential_insert();
+	test_descending_insert();
+	test_shuffled_insert();
+	test_duplicate_split();
+	test_remove();
+	test_pointer_comparator();
+	test_frozen_move();
+
+	cout << "btree regression tests passed\n";
+	return 0;
+}
@@ -23,9 +23,9 @@ class BloomFilter {
 
         BloomFilter& operator=(const BloomFilter&);
 
-        void insert(const _Tp) noexcept;
+        void insert(const _Tp&) noexcept;
 
-        bool lookup(const _Tp) const noexcept;
+        bool lookup(const _Tp&) const noexcept;
 
         constexpr double fp_prob(void) const noexcept;
 
@@ -82,7 +82,7 @@ BloomFilter<_Tp, HF>& BloomFilter<_Tp, HF>::operator=(const BloomFilter& bloom)
 }
 
 template <typename _Tp, class HF>
-void BloomFilter<_Tp, HF>::insert(const _Tp key) noexcept {
+void BloomFilter<_Tp, HF>::insert(const _Tp& key) noexcept {
     uint32_t _hash;
     for (size_t i = 0; i < hash_count; i++) {
         _hash = hasher(key, i) % size;
@@ -93,7 +93,7 @@ void BloomFilter<_Tp, HF>::insert(const _Tp key) noexcept {
 }
 
 template <typename _Tp, class HF>
-bool BloomFilter<_Tp, HF>::lookup(const _Tp key) const noexcept {
+bool BloomFilter<_Tp, HF>::lookup(const _Tp& key) const noexcept {
     uint32_t _hash;
     for (size_t i = 0; i < hash_count; i++) {
         _hash = hasher(key, i) % size;
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <random>
+#include <vector>
+#include <utility>
+#include "tablememory.hpp"
+
+#ifndef _CUCKOOFILTER_INSERTED
+    #define _CUCKOOFILTER_INSERTED 0
+#endif
+
+#ifndef _CUCKOOFILTER_STASHED
+    #define _CUCKOOFILTER_STASHED 1
+#endif
+
+#ifndef _CUCKOOFILTER_FULL
+    #define _CUCKOOFILTER_FULL 2
+#endif
+
+#ifndef _ADAPTIVECUCKOO_SELECTORS
+    #define _ADAPTIVECUCKOO_SELECTORS 4
+#endif
+
+template <typename _Tp, class HashFamily>
+class AdaptiveCuckooFilter {
+    private:
+        const uint64_t size;
+        const uint64_t mask;
+        const uint32_t threshold;
+        const size_t n_buckets;
+        uint64_t key_count;
+        uint64_t adapt_count;
+
+        uint16_t* table;
+        uint8_t* selectors;
+        uint8_t pages;
+
+        std::vector<_Tp> reverse_map;
+        std::vector<bool> reverse_used;
+        const bool track_keys;
+
+        std::vector<std::pair<uint64_t, uint8_t>> kick_log;
+
+        std::minstd_rand prng;
+
+        const HashFamily hasher;
+
+        static uint64_t round_pow2(uint64_t) noexcept;
+
+        uint16_t fingerprint(const _Tp&, const uint8_t) const noexcept;
+
+        uint32_t alt_index(uint16_t, uint32_t) const noexcept;
+
+        bool match(const _Tp&, uint32_t, uint16_t*) const noexcept;
+
+        void rollback(_Tp) noexcept;
+
+    public:
+        explicit AdaptiveCuckooFilter(const uint64_t, const uint32_t, const size_t = 4, const bool = true);
+
+        AdaptiveCuckooFilter(const AdaptiveCuckooFilter&) = delete;
+
+        AdaptiveCuckooFilter& operator=(const AdaptiveCuckooFilter&) = delete;
+
+        ~AdaptiveCuckooFilter(void);
+
+        uint8_t insert(const _Tp&);
+
+        bool lookup(const _Tp&) const noexcept;
+
+        bool remove(const _Tp&) noexcept;
+
+        uint32_t report_false_positive(const _Tp&);
+
+        double load_factor(void) const noexcept;
+
+        uint64_t num_keys(void) const noexcept;
+
+        uint64_t num_adaptations(void) const noexcept;
+
+        uint64_t size_in_bytes(void) const noexcept;
+};
+
+template <typename _Tp, class HF>
+AdaptiveCuckooFilter<_Tp, HF>::AdaptiveCuckooFilter(const uint64_t size, const uint32_t relocation_threshold, const size_t buckets, const bool reverse_map)
+    : size(round_pow2(size)), mask(round_pow2(size) - 1), threshold(relocation_threshold), n_buckets(buckets),
+    key_count(0), adapt_count(0), pages(_TABLEMEMORY_DEFAULT_PAGES), track_keys(reverse_map), prng(), hasher() {
+
+    table = (uint16_t*) TableMemory::allocate(this->size * n_buckets * sizeof(uint16_t), pages);
+    selectors = new uint8_t[this->size * n_buckets]();
+
+    if (track_keys) {
+        this->reverse_map.resize(this->size * n_buckets);
+        reverse_used.resize(this->size * n_buckets, false);
+    }
+}
+
+template <typename _Tp, class HF>
+AdaptiveCuckooFilter<_Tp, HF>::~AdaptiveCuckooFilter(void) {
+    TableMemory::release(table, size * n_buckets * sizeof(uint16_t), pages);
+    delete[] selectors;
+}
+
+template <typename _Tp, class HF>
+uint64_t AdaptiveCuckooFilter<_Tp, HF>::round_pow2(uint64_t n) noexcept {
+    uint64_t pow2 = 1;
+    while (pow2 < n) {
+        pow2 <<= 1;
+    }
+
+    return pow2;
+}
+
+template <typename _Tp, class HF>
+uint16_t AdaptiveCuckooFilter<_Tp, HF>::fingerprint(const _Tp& key, const uint8_t selector) const noexcept {
+    uint16_t fp = hasher(key, selector + 1) >> 16;
+    return fp + (fp == 0);
+}
+
+template <typename _Tp, class HF>
+uint32_t AdaptiveCuckooFilter<_Tp, HF>::alt_index(uint16_t tag, uint32_t _hash) const noexcept {
+    return (_hash ^ (tag * 0x5bd1e995U)) & mask;
+}
+
+template <typename _Tp, class HF>
+bool AdaptiveCuckooFilter<_Tp, HF>::match(const _Tp& key, uint32_t bucket, uint16_t* cache) const noexcept {
+    for (size_t i = 0; i < n_buckets; i++) {
+        const uint64_t pos = bucket * n_buckets + i;
+        if (not table[pos]) {
+            continue;
+        }
+
+        const uint8_t selector = selectors[pos];
+        if (not cache[selector]) {
+            cache[selector] = fingerprint(key, selector);
+        }
+
+        if (table[pos] == cache[selector]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename _Tp, class HF>
+void AdaptiveCuckooFilter<_Tp, HF>::rollback(_Tp homeless) noexcept {
+    while (not kick_log.empty()) {
+        const uint64_t pos = kick_log.back().first;
+        const uint8_t selector = kick_log.back().second;
+        kick_log.pop_back();
+
+        std::swap(homeless, reverse_map[pos]);
+        table[pos] = fingerprint(reverse_map[pos], selector);
+        selectors[pos] = selector;
+    }
+}
+
+template <typename _Tp, class HF>
+uint8_t AdaptiveCuckooFilter<_Tp, HF>::insert(const _Tp& key) {
+    _Tp curr_key = key;
+    uint32_t _hash = hasher(key) & mask;
+    uint16_t tag = hasher(key, _ADAPTIVECUCKOO_SELECTORS + 1) >> 16;
+
+    kick_log.clear();
+
+    for (uint32_t count = 0; count < threshold; count++) {
+        const uint32_t buckets[2] = {_hash, alt_index(tag, _hash)};
+
+        for (uint32_t bucket : buckets) {
+            for (size_t i = 0; i < n_buckets; i++) {
+                const uint64_t pos = bucket * n_buckets + i;
+                if (not table[pos]) {
+                    table[pos] = fingerprint(curr_key, 0);
+                    selectors[pos] = 0;
+
+                    if (track_keys) {
+                        reverse_map[pos] = curr_key;
+                        reverse_used[pos] = true;
+                    }
+
+                    key_count++;
+                    return _CUCKOOFILTER_INSERTED;
+                }
+            }
+        }
+
+        if (not track_keys) {
+            return _CUCKOOFILTER_FULL;
+        }
+
+        const uint32_t target = buckets[prng() % 2];
+        const uint64_t pos = target * n_buckets + prng() % n_buckets;
+
+        kick_log.emplace_back(pos, selectors[pos]);
+        std::swap(curr_key, reverse_map[pos]);
+        table[pos] = fingerprint(reverse_map[pos], 0);
+        selectors[pos] = 0;
+
+        tag = hasher(curr_key, _ADAPTIVECUCKOO_SELECTORS + 1) >> 16;
+        _hash = alt_index(tag, target);
+    }
+
+    rollback(curr_key);
+    return _CUCKOOFILTER_FULL;
+}
+
+template <typename _Tp, class HF>
+bool AdaptiveCuckooFilter<_Tp, HF>::lookup(const _Tp& key) const noexcept {
+    uint16_t cache[_ADAPTIVECUCKOO_SELECTORS] = {0};
+    uint32_t _hash = hasher(key) & mask;
+    uint16_t tag = hasher(key, _ADAPTIVECUCKOO_SELECTORS + 1) >> 16;
+
+    return match(key, _hash, cache) or match(key, alt_index(tag, _hash), cache);
+}
+
+template <typename _Tp, class HF>
+bool AdaptiveCuckooFilter<_Tp, HF>::remove(const _Tp& key) noexcept {
+    uint32_t _hash = hasher(key) & mask;
+    uint16_t tag = hasher(key, _ADAPTIVECUCKOO_SELECTORS + 1) >> 16;
+    const uint32_t buckets[2] = {_hash, alt_index(tag, _hash)};
+
+    for (uint32_t bucket : buckets) {
+        for (size_t i = 0; i < n_buckets; i++) {
+            const uint64_t pos = bucket * n_buckets + i;
+            if (not table[pos]) {
+                continue;
+            }
+
+            if (track_keys ? (reverse_used[pos] and reverse_map[pos] == key) : (table[pos] == fingerprint(key, selectors[pos]))) {
+                table[pos] = 0;
+                selectors[pos] = 0;
+
+                if (track_keys) {
+                    reverse_used[pos] = false;
+                }
+
+                key_count--;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+template <typename _Tp, class HF>
+uint32_t AdaptiveCuckooFilter<_Tp, HF>::report_false_positive(const _Tp& key) {
+    if (not track_keys) {
+        return 0;
+    }
+
+    uint32_t _hash = hasher(key) & mask;
+    uint16_t tag = hasher(key, _ADAPTIVECUCKOO_SELECTORS + 1) >> 16;
+    const uint32_t buckets[2] = {_hash, alt_index(tag, _hash)};
+    uint32_t fixed = 0;
+
+    for (uint32_t bucket : buckets) {
+        for (size_t i = 0; i < n_buckets; i++) {
+            const uint64_t pos = bucket * n_buckets + i;
+            if (not table[pos] or not reverse_used[pos] or reverse_map[pos] == key) {
+                continue;
+            }
+
+            uint8_t selector = selectors[pos];
+            if (table[pos] != fingerprint(key, selector)) {
+                continue;
+            }
+
+            for (uint8_t step = 1; step < _ADAPTIVECUCKOO_SELECTORS; step++) {
+                uint8_t next = (selector + step) % _ADAPTIVECUCKOO_SELECTORS;
+                uint16_t fp = fingerprint(reverse_map[pos], next);
+
+                if (fp != fingerprint(key, next)) {
+                    table[pos] = fp;
+                    selectors[pos] = next;
+                    fixed++;
+                    break;
+                }
+            }
+        }
+    }
+
+    adapt_count += fixed;
+    return fixed;
+}
+
+template <typename _Tp, class HF>
+double AdaptiveCuckooFilter<_Tp, HF>::load_factor(void) const noexcept {
+    return double(key_count) / (size * n_buckets);
+}
+
+template <typename _Tp, class HF>
+uint64_t AdaptiveCuckooFilter<_Tp, HF>::num_keys(void) const noexcept {
+    return key_count;
+}
+
+template <typename _Tp, class HF>
+uint64_t AdaptiveCuckooFilter<_Tp, HF>::num_adaptations(void) const noexcept {
+    return adapt_count;
+}
+
+template <typename _Tp, class HF>
+uint64_t AdaptiveCuckooFilter<_Tp, HF>::size_in_bytes(void) const noexcept {
+    return size * n_buckets * (sizeof(uint16_t) + sizeof(uint8_t));
+}
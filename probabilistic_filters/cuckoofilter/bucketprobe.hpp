@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__AVX2__) or defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+class BucketProbe {
+    public:
+        static uint32_t match(const uint64_t*, const size_t, const uint64_t) noexcept;
+
+        static bool contains(const uint64_t*, const uint64_t*, const size_t, const uint64_t) noexcept;
+
+        static uint32_t match_tags(const uint8_t*, const size_t, const uint8_t) noexcept;
+
+        static size_t first(const uint32_t) noexcept;
+
+        static void prefetch(const uint64_t*) noexcept;
+};
+
+inline uint32_t BucketProbe::match(const uint64_t* bucket, const size_t slots, const uint64_t fp) noexcept {
+    uint32_t mask = 0;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i needle = _mm256_set1_epi64x(fp);
+
+    for (; i + 4 <= slots; i += 4) {
+        __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*) (bucket + i)), needle);
+        mask |= uint32_t(_mm256_movemask_pd(_mm256_castsi256_pd(eq))) << i;
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i needle_128 = _mm_set1_epi64x(fp);
+
+    for (; i + 2 <= slots; i += 2) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*) (bucket + i)), needle_128);
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        mask |= uint32_t(_mm_movemask_pd(_mm_castsi128_pd(eq))) << i;
+    }
+#endif
+
+    for (; i < slots; i++) {
+        mask |= uint32_t(bucket[i] == fp) << i;
+    }
+
+    return mask;
+}
+
+inline bool BucketProbe::contains(const uint64_t* bucket, const uint64_t* alt_bucket, const size_t slots, const uint64_t fp) noexcept {
+#if defined(__AVX2__)
+    if (slots == 4) {
+        const __m256i needle = _mm256_set1_epi64x(fp);
+        __m256i eq = _mm256_or_si256(
+            _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*) bucket), needle),
+            _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*) alt_bucket), needle));
+        return not _mm256_testz_si256(eq, eq);
+    }
+#endif
+
+    return match(bucket, slots, fp) or match(alt_bucket, slots, fp);
+}
+
+inline uint32_t BucketProbe::match_tags(const uint8_t* tags, const size_t slots, const uint8_t tag) noexcept {
+    uint32_t mask = 0;
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(tag);
+
+    for (; i + 16 <= slots; i += 16) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (tags + i)), needle);
+        mask |= uint32_t(_mm_movemask_epi8(eq)) << i;
+    }
+
+    if (i + 8 <= slots) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i*) (tags + i)), needle);
+        mask |= uint32_t(_mm_movemask_epi8(eq) bitand 0xff) << i;
+        i += 8;
+    }
+#endif
+
+    for (; i < slots; i++) {
+        mask |= uint32_t(tags[i] == tag) << i;
+    }
+
+    return mask;
+}
+
+inline size_t BucketProbe::first(const uint32_t mask) noexcept {
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    size_t i = 0;
+    while (not ((mask >> i) bitand 1)) {
+        i++;
+    }
+
+    return i;
+#endif
+}
+
+inline void BucketProbe::prefetch(const uint64_t* bucket) noexcept {
+#if defined(__GNUC__)
+    __builtin_prefetch(bucket, 0, 3);
+#endif
+}
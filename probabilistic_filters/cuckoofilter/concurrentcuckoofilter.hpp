@@ -0,0 +1,363 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <utility>
+
+#ifndef _CUCKOOFILTER_INSERTED
+    #define _CUCKOOFILTER_INSERTED 0
+#endif
+
+#ifndef _CUCKOOFILTER_STASHED
+    #define _CUCKOOFILTER_STASHED 1
+#endif
+
+#ifndef _CUCKOOFILTER_FULL
+    #define _CUCKOOFILTER_FULL 2
+#endif
+
+#ifndef _CUCKOOFILTER_LOCK_STRIPES
+    #define _CUCKOOFILTER_LOCK_STRIPES 2048
+#endif
+
+#ifndef _CUCKOOFILTER_MAX_PATH
+    #define _CUCKOOFILTER_MAX_PATH 128
+#endif
+
+template <typename _Tp, class HashFamily, class FingerprintFamily>
+class ConcurrentCuckooFilter {
+    private:
+        struct PathEntry {
+            uint32_t bucket;
+            uint32_t slot;
+            uint64_t fp;
+        };
+
+        const uint64_t size;
+        const uint64_t mask;
+        const uint32_t threshold;
+        const size_t n_slots;
+        std::atomic<uint64_t> key_count;
+
+        std::atomic<uint64_t>* table;
+        std::atomic<uint32_t>* versions;
+        std::atomic_flag locks[_CUCKOOFILTER_LOCK_STRIPES];
+
+        const HashFamily hasher;
+        const FingerprintFamily fingerprint;
+
+        static uint64_t round_pow2(uint64_t) noexcept;
+
+        uint32_t alt_index(uint64_t, uint32_t) const noexcept;
+
+        void lock_buckets(uint32_t, uint32_t) noexcept;
+
+        void unlock_buckets(uint32_t, uint32_t) noexcept;
+
+        void begin_write(uint32_t) noexcept;
+
+        void end_write(uint32_t) noexcept;
+
+        bool try_add(uint64_t, uint32_t, uint32_t) noexcept;
+
+        size_t find_path(PathEntry*, uint32_t, uint32_t) const noexcept;
+
+        bool move_along(const PathEntry*, size_t) noexcept;
+
+    public:
+        explicit ConcurrentCuckooFilter(const uint64_t, const uint32_t, const size_t = 4);
+
+        ConcurrentCuckooFilter(const ConcurrentCuckooFilter&) = delete;
+
+        ConcurrentCuckooFilter& operator=(const ConcurrentCuckooFilter&) = delete;
+
+        ~ConcurrentCuckooFilter(void);
+
+        uint8_t insert(const _Tp&) noexcept;
+
+        bool lookup(const _Tp&) const noexcept;
+
+        bool remove(const _Tp&) noexcept;
+
+        double load_factor(void) const noexcept;
+
+        uint64_t num_keys(void) const noexcept;
+
+        constexpr uint64_t size_in_bytes(void) const noexcept;
+};
+
+template <typename _Tp, class HF, class FF>
+ConcurrentCuckooFilter<_Tp, HF, FF>::ConcurrentCuckooFilter(const uint64_t size, const uint32_t relocation_threshold, const size_t slots)
+    : size(round_pow2(size)), mask(round_pow2(size) - 1), threshold(relocation_threshold),
+    n_slots(slots), key_count(0), hasher(), fingerprint() {
+
+    table = new std::atomic<uint64_t>[this->size * n_slots];
+    for (uint64_t i = 0; i < this->size * n_slots; i++) {
+        table[i].store(0, std::memory_order_relaxed);
+    }
+
+    versions = new std::atomic<uint32_t>[this->size];
+    for (uint64_t i = 0; i < this->size; i++) {
+        versions[i].store(0, std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < _CUCKOOFILTER_LOCK_STRIPES; i++) {
+        locks[i].clear();
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+ConcurrentCuckooFilter<_Tp, HF, FF>::~ConcurrentCuckooFilter(void) {
+    delete[] versions;
+    delete[] table;
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t ConcurrentCuckooFilter<_Tp, HF, FF>::round_pow2(uint64_t n) noexcept {
+    uint64_t pow2 = 1;
+    while (pow2 < n) {
+        pow2 <<= 1;
+    }
+
+    return pow2;
+}
+
+template <typename _Tp, class HF, class FF>
+uint32_t ConcurrentCuckooFilter<_Tp, HF, FF>::alt_index(uint64_t fp, uint32_t _hash) const noexcept {
+    return (_hash ^ hasher(fp)) & mask;
+}
+
+template <typename _Tp, class HF, class FF>
+void ConcurrentCuckooFilter<_Tp, HF, FF>::lock_buckets(uint32_t b1, uint32_t b2) noexcept {
+    size_t s1 = b1 % _CUCKOOFILTER_LOCK_STRIPES;
+    size_t s2 = b2 % _CUCKOOFILTER_LOCK_STRIPES;
+    if (s1 > s2) {
+        std::swap(s1, s2);
+    }
+
+    while (locks[s1].test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    if (s2 != s1) {
+        while (locks[s2].test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+void ConcurrentCuckooFilter<_Tp, HF, FF>::unlock_buckets(uint32_t b1, uint32_t b2) noexcept {
+    size_t s1 = b1 % _CUCKOOFILTER_LOCK_STRIPES;
+    size_t s2 = b2 % _CUCKOOFILTER_LOCK_STRIPES;
+
+    locks[s1].clear(std::memory_order_release);
+    if (s2 != s1) {
+        locks[s2].clear(std::memory_order_release);
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+void ConcurrentCuckooFilter<_Tp, HF, FF>::begin_write(uint32_t bucket) noexcept {
+    versions[bucket].store(versions[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+template <typename _Tp, class HF, class FF>
+void ConcurrentCuckooFilter<_Tp, HF, FF>::end_write(uint32_t bucket) noexcept {
+    versions[bucket].store(versions[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <typename _Tp, class HF, class FF>
+bool ConcurrentCuckooFilter<_Tp, HF, FF>::try_add(uint64_t fp, uint32_t b1, uint32_t b2) noexcept {
+    const uint32_t buckets[2] = {b1, b2};
+
+    for (uint32_t bucket : buckets) {
+        std::atomic<uint64_t>* row = table + bucket * n_slots;
+
+        for (size_t i = 0; i < n_slots; i++) {
+            if (not row[i].load(std::memory_order_relaxed)) {
+                begin_write(bucket);
+                row[i].store(fp, std::memory_order_relaxed);
+                end_write(bucket);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+template <typename _Tp, class HF, class FF>
+size_t ConcurrentCuckooFilter<_Tp, HF, FF>::find_path(PathEntry* path, uint32_t b1, uint32_t b2) const noexcept {
+    thread_local std::minstd_rand prng(std::random_device{}());
+
+    const size_t max_len = std::min<size_t>(threshold, _CUCKOOFILTER_MAX_PATH - 1);
+    uint32_t bucket = (prng() % 2) ? b1 : b2;
+
+    for (size_t len = 0; len < max_len; len++) {
+        uint32_t slot = prng() % n_slots;
+        uint64_t fp = table[bucket * n_slots + slot].load(std::memory_order_relaxed);
+        path[len] = {bucket, slot, fp};
+
+        if (not fp) {
+            return len + 1;
+        }
+
+        bucket = alt_index(fp, bucket);
+        for (size_t i = 0; i < n_slots; i++) {
+            if (not table[bucket * n_slots + i].load(std::memory_order_relaxed)) {
+                path[len + 1] = {bucket, uint32_t(i), 0};
+                return len + 2;
+            }
+        }
+    }
+
+    return 0;
+}
+
+template <typename _Tp, class HF, class FF>
+bool ConcurrentCuckooFilter<_Tp, HF, FF>::move_along(const PathEntry* path, size_t len) noexcept {
+    for (size_t i = len - 1; i > 0; i--) {
+        const PathEntry& from = path[i - 1];
+        const PathEntry& to = path[i];
+
+        lock_buckets(from.bucket, to.bucket);
+
+        std::atomic<uint64_t>& src = table[from.bucket * n_slots + from.slot];
+        std::atomic<uint64_t>& dest = table[to.bucket * n_slots + to.slot];
+
+        if (src.load(std::memory_order_relaxed) != from.fp or dest.load(std::memory_order_relaxed)) {
+            unlock_buckets(from.bucket, to.bucket);
+            return false;
+        }
+
+        begin_write(from.bucket);
+        if (to.bucket != from.bucket) {
+            begin_write(to.bucket);
+        }
+
+        dest.store(from.fp, std::memory_order_relaxed);
+        src.store(0, std::memory_order_relaxed);
+
+        if (to.bucket != from.bucket) {
+            end_write(to.bucket);
+        }
+        end_write(from.bucket);
+
+        unlock_buckets(from.bucket, to.bucket);
+    }
+
+    return true;
+}
+
+template <typename _Tp, class HF, class FF>
+uint8_t ConcurrentCuckooFilter<_Tp, HF, FF>::insert(const _Tp& key) noexcept {
+    uint64_t fp = fingerprint(key);
+    fp += (fp == 0);
+    uint32_t _hash = hasher(key) & mask;
+    uint32_t alt_hash = alt_index(fp, _hash);
+
+    PathEntry path[_CUCKOOFILTER_MAX_PATH];
+
+    for (uint32_t attempt = 0; attempt < threshold; attempt++) {
+        lock_buckets(_hash, alt_hash);
+        bool added = try_add(fp, _hash, alt_hash);
+        unlock_buckets(_hash, alt_hash);
+
+        if (added) {
+            key_count.fetch_add(1, std::memory_order_relaxed);
+            return _CUCKOOFILTER_INSERTED;
+        }
+
+        size_t len = find_path(path, _hash, alt_hash);
+        if (not len) {
+            return _CUCKOOFILTER_FULL;
+        }
+
+        move_along(path, len);
+    }
+
+    return _CUCKOOFILTER_FULL;
+}
+
+template <typename _Tp, class HF, class FF>
+bool ConcurrentCuckooFilter<_Tp, HF, FF>::lookup(const _Tp& key) const noexcept {
+    uint64_t fp = fingerprint(key);
+    fp += (fp == 0);
+    uint32_t _hash = hasher(key) & mask;
+    uint32_t alt_hash = alt_index(fp, _hash);
+
+    const std::atomic<uint64_t>* row1 = table + _hash * n_slots;
+    const std::atomic<uint64_t>* row2 = table + alt_hash * n_slots;
+
+    while (true) {
+        uint32_t v1 = versions[_hash].load(std::memory_order_acquire);
+        uint32_t v2 = versions[alt_hash].load(std::memory_order_acquire);
+
+        if ((v1 bitor v2) bitand 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        bool found = false;
+        for (size_t i = 0; i < n_slots; i++) {
+            if (row1[i].load(std::memory_order_relaxed) == fp or row2[i].load(std::memory_order_relaxed) == fp) {
+                found = true;
+                break;
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (versions[_hash].load(std::memory_order_relaxed) == v1 and versions[alt_hash].load(std::memory_order_relaxed) == v2) {
+            return found;
+        }
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+bool ConcurrentCuckooFilter<_Tp, HF, FF>::remove(const _Tp& key) noexcept {
+    uint64_t fp = fingerprint(key);
+    fp += (fp == 0);
+    uint32_t _hash = hasher(key) & mask;
+    uint32_t alt_hash = alt_index(fp, _hash);
+    const uint32_t buckets[2] = {_hash, alt_hash};
+
+    lock_buckets(_hash, alt_hash);
+
+    for (uint32_t bucket : buckets) {
+        std::atomic<uint64_t>* row = table + bucket * n_slots;
+
+        for (size_t i = 0; i < n_slots; i++) {
+            if (row[i].load(std::memory_order_relaxed) == fp) {
+                begin_write(bucket);
+                row[i].store(0, std::memory_order_relaxed);
+                end_write(bucket);
+
+                unlock_buckets(_hash, alt_hash);
+                key_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    unlock_buckets(_hash, alt_hash);
+    return false;
+}
+
+template <typename _Tp, class HF, class FF>
+double ConcurrentCuckooFilter<_Tp, HF, FF>::load_factor(void) const noexcept {
+    return double(num_keys()) / (size * n_slots);
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t ConcurrentCuckooFilter<_Tp, HF, FF>::num_keys(void) const noexcept {
+    return key_count.load(std::memory_order_relaxed);
+}
+
+template <typename _Tp, class HF, class FF>
+constexpr uint64_t ConcurrentCuckooFilter<_Tp, HF, FF>::size_in_bytes(void) const noexcept {
+    return size * n_slots * sizeof(uint64_t) + size * sizeof(uint32_t);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _CUCKOOFILE_VERSION
+    #define _CUCKOOFILE_VERSION 3
+#endif
+
+#ifndef _CUCKOOFILE_TABLE_OFFSET
+    #define _CUCKOOFILE_TABLE_OFFSET 4096
+#endif
+
+#ifndef _CUCKOOFILE_KIND_LL
+    #define _CUCKOOFILE_KIND_LL 0
+#endif
+
+#ifndef _CUCKOOFILE_KIND_HL
+    #define _CUCKOOFILE_KIND_HL 1
+#endif
+
+#ifndef _CUCKOOFILTER_STASH_SIZE
+    #define _CUCKOOFILTER_STASH_SIZE 8
+#endif
+
+struct CuckooFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint64_t size;
+    uint64_t n_buckets;
+    uint32_t threshold;
+    uint32_t fingerprint_bits;
+    uint32_t hash_family;
+    uint32_t fingerprint_family;
+    uint64_t key_count;
+    uint64_t failed_count;
+    uint64_t stash_count;
+    uint64_t stash[_CUCKOOFILTER_STASH_SIZE];
+    uint64_t table_offset;
+    uint64_t table_bytes;
+    uint32_t stash_hash[_CUCKOOFILTER_STASH_SIZE];
+};
+
+class CuckooFile {
+    private:
+        static constexpr char magic[8] = {'C', 'U', 'C', 'K', 'O', 'O', 'F', '\0'};
+
+    public:
+        static CuckooFileHeader header(const uint32_t, const uint32_t, const uint32_t) noexcept;
+
+        static void save(const std::string&, const CuckooFileHeader&, const void*);
+
+        static CuckooFileHeader read_header(const std::string&, const uint32_t, const uint32_t, const uint32_t);
+};
+
+inline CuckooFileHeader CuckooFile::header(const uint32_t kind, const uint32_t hash_family, const uint32_t fingerprint_family) noexcept {
+    CuckooFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic, sizeof(magic));
+
+    header.version = _CUCKOOFILE_VERSION;
+    header.kind = kind;
+    header.fingerprint_bits = 64;
+    header.hash_family = hash_family;
+    header.fingerprint_family = fingerprint_family;
+    header.table_offset = _CUCKOOFILE_TABLE_OFFSET;
+    return header;
+}
+
+inline void CuckooFile::save(const std::string& path, const CuckooFileHeader& header, const void* table) {
+    const std::string tmp_path = path + ".tmp";
+    std::fstream file(tmp_path.c_str(), std::ios_base::out bitor std::ios_base::trunc bitor std::ios_base::binary);
+    if (not file.good()) {
+        throw std::fstream::failure("failed to open file");
+    }
+
+    char padding[_CUCKOOFILE_TABLE_OFFSET] = {0};
+    std::memcpy(padding, &header, sizeof(header));
+
+    file.write(padding, _CUCKOOFILE_TABLE_OFFSET);
+    file.write((const char*) table, header.table_bytes);
+    file.close();
+
+    if (file.fail() or std::rename(tmp_path.c_str(), path.c_str())) {
+        std::remove(tmp_path.c_str());
+        throw std::fstream::failure("failed to write file");
+    }
+}
+
+inline CuckooFileHeader CuckooFile::read_header(const std::string& path, const uint32_t kind, const uint32_t hash_family, const uint32_t fingerprint_family) {
+    std::fstream file(path.c_str(), std::ios_base::in bitor std::ios_base::binary);
+    if (not file.good()) {
+        throw std::fstream::failure("failed to open file");
+    }
+
+    CuckooFileHeader header;
+    if (not file.read((char*) &header, sizeof(header)) or std::memcmp(header.magic, magic, sizeof(magic))) {
+        throw std::runtime_error("not a cuckoo filter file: " + path);
+    }
+
+    if (header.version != _CUCKOOFILE_VERSION) {
+        throw std::runtime_error("unsupported cuckoo filter file version: " + std::to_string(header.version));
+    }
+
+    if (header.kind != kind or header.hash_family != hash_family or header.fingerprint_family != fingerprint_family) {
+        throw std::runtime_error("cuckoo filter file does not match filter type: " + path);
+    }
+
+    if (header.fingerprint_bits != 64 or header.stash_count > _CUCKOOFILTER_STASH_SIZE or header.table_bytes != header.size * header.n_buckets * sizeof(uint64_t)
+        or (kind == _CUCKOOFILE_KIND_HL and (header.size bitand (header.size - 1)))) {
+        throw std::runtime_error("corrupt cuckoo filter file: " + path);
+    }
+
+    for (uint64_t i = 0; i < header.stash_count; i++) {
+        if (header.stash_hash[i] >= header.size) {
+            throw std::runtime_error("corrupt cuckoo filter file: " + path);
+        }
+    }
+
+    file.seekg(0, std::ios_base::end);
+    if (uint64_t(file.tellg()) < header.table_offset + header.table_bytes) {
+        throw std::runtime_error("truncated file: " + path);
+    }
+
+    return header;
+}
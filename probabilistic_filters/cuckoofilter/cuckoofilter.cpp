@@ -2,11 +2,76 @@
 #include <string>
 #include <chrono>
 #include <fstream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <unordered_set>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "murmurhash3.hpp"
 #include "rabinfingerprint.hpp"
 #include "cuckoofilter.hpp"
+#include "concurrentcuckoofilter.hpp"
+#include "dynamiccuckoofilter.hpp"
+#include "adaptivecuckoofilter.hpp"
+#include "mortoncuckoofilter.hpp"
+#include "shardedcuckoofilter.hpp"
+#include "cuckoohashmap.hpp"
 using namespace std;
 
+thread_local uint64_t* counted_allocations = nullptr;
+
+void* operator new(size_t bytes) {
+    if (counted_allocations) {
+        (*counted_allocations)++;
+    }
+
+    if (void* ptr = malloc(bytes ? bytes : 1)) {
+        return ptr;
+    }
+
+    throw bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+class AllocationScope {
+    private:
+        uint64_t count;
+        uint64_t* previous;
+
+    public:
+        AllocationScope(void) : count(0), previous(counted_allocations) {
+            counted_allocations = &count;
+        }
+
+        AllocationScope(const AllocationScope&) = delete;
+
+        AllocationScope& operator=(const AllocationScope&) = delete;
+
+        ~AllocationScope(void) {
+            counted_allocations = previous;
+        }
+
+        uint64_t allocations(void) const noexcept {
+            return count;
+        }
+};
+
 uint64_t count_lines(const string& filename) {
     fstream file(filename.c_str(), ios_base::in);
     if (not file.good()) {
@@ -24,6 +89,23 @@ uint64_t count_lines(const string& filename) {
     return count;
 }
 
+vector<string> read_keys(const string& filename, uint64_t limit) {
+    fstream file(filename.c_str(), ios_base::in);
+    if (not file.good()) {
+        file.close();
+        throw fstream::failure("failed to open file");
+    }
+
+    vector<string> keys;
+    string line;
+    while (getline(file, line) and limit--) {
+        keys.push_back(line);
+    }
+
+    file.close();
+    return keys;
+}
+
 void populate_filter(CuckooFilterLL<string, MurMurHash3, RabinFingerprint>& cuckoo, const string& filename, uint64_t limit) {
     fstream file(filename.c_str(), ios_base::in);
     if (not file.good()) {
@@ -33,15 +115,7 @@ void populate_filter(CuckooFilterLL<string, MurMurHash3, RabinFingerprint>& cuck
 
     string line;
     while (getline(file, line) and limit--) {
-        try {
-            cuckoo.insert(line);
-        }
-        catch (const out_of_range& exc) {
-            continue;
-        }
-        catch (const overflow_error& exc) {
-            continue;
-        }
+        cuckoo.insert(line);
     }
 
     file.close();
@@ -56,15 +130,41 @@ void populate_filter(CuckooFilterHL<string, MurMurHash3, RabinFingerprint>& cuck
 
     string line;
     while (getline(file, line) and limit--) {
-        try {
-            cuckoo.insert(line);
+        cuckoo.insert(line);
+    }
+
+    file.close();
+}
+
+void print_stats(const CuckooFilterStats& stats) {
+    uint64_t buckets = 0;
+    for (uint64_t count : stats.bucket_occupancy) {
+        buckets += count;
+    }
+
+    std::cout << "\nkick chain length\tinsertions\n";
+    for (size_t low = 0, high = 0; low < stats.kick_chains.size(); low = high + 1, high = 2 * low) {
+        uint64_t count = 0;
+        for (size_t i = low; i <= high and i < stats.kick_chains.size(); i++) {
+            count += stats.kick_chains[i];
         }
-        catch (const overflow_error& exc) {
-            continue;
+
+        if (count) {
+            std::cout << low << (high > low ? "-" + to_string(min(high, stats.kick_chains.size() - 1)) : "") << "\t\t\t" << count << "\n";
         }
     }
 
-    file.close();
+    std::cout << "\noccupied slots\t\tbuckets\n";
+    for (size_t i = 0; i < stats.bucket_occupancy.size(); i++) {
+        std::cout << i << "\t\t\t" << stats.bucket_occupancy[i] << " (" << 100.0 * stats.bucket_occupancy[i] / buckets << " %)\n";
+    }
+
+    std::cout << "\nstashed insertions\t: " << stats.stashed;
+    std::cout << "\nfailed insertions\t: " << stats.failed;
+    if (stats.failed) {
+        std::cout << "\nload at first failure\t: " << 100 * stats.load_at_first_failure << " %";
+    }
+    std::cout << "\n";
 }
 
 void benchmark(CuckooFilterLL<string, MurMurHash3, RabinFingerprint>& cuckoo, const string& filename, uint64_t limit) {
@@ -85,8 +185,12 @@ void benchmark(CuckooFilterLL<string, MurMurHash3, RabinFingerprint>& cuckoo, co
     std::cout << "\nsize of filter (bytes)\t\t: " << cuckoo.size_in_bytes();
     std::cout << "\naverage size per key (bytes)\t: " << ((double) (cuckoo.size_in_bytes()) / 2) / cuckoo.num_keys();
     std::cout << "\nload factor\t\t\t: " << 100 * cuckoo.load_factor() << " %";
+    std::cout << "\nstashed keys\t\t\t: " << cuckoo.num_stashed();
+    std::cout << "\nfailed insertions\t\t: " << cuckoo.num_failures();
     std::cout << "\naverage key insertion time\t: " << time << " ns\n";
 
+    print_stats(cuckoo.stats());
+
     std::cout << "\n1. lookup\n2. deletion\n";
 
     string input; size_t action;
@@ -162,8 +266,12 @@ void benchmark(CuckooFilterHL<string, MurMurHash3, RabinFingerprint>& cuckoo, co
     std::cout << "\nsize of filter (bytes)\t\t: " << cuckoo.size_in_bytes();
     std::cout << "\naverage size per key (bytes)\t: " << ((double) (cuckoo.size_in_bytes()) / 2) / cuckoo.num_keys();
     std::cout << "\nload factor\t\t\t: " << 100 * cuckoo.load_factor() << " %";
+    std::cout << "\nstashed keys\t\t\t: " << cuckoo.num_stashed();
+    std::cout << "\nfailed insertions\t\t: " << cuckoo.num_failures();
     std::cout << "\naverage key insertion time\t: " << time << " ns\n";
 
+    print_stats(cuckoo.stats());
+
     std::cout << "\n1. lookup\n2. deletion\n";
 
     string input; size_t action;
@@ -221,6 +329,493 @@ void benchmark(CuckooFilterHL<string, MurMurHash3, RabinFingerprint>& cuckoo, co
     }
 }
 
+void benchmark_concurrent(const string& filename, uint64_t limit) {
+    using namespace std::chrono;
+
+    vector<string> keys = read_keys(filename, limit);
+    const size_t half = keys.size() / 2;
+    const unsigned max_threads = max(1u, thread::hardware_concurrency());
+
+    std::cout << "\nthreads\tlookups/sec\t\tupdates/sec\n";
+
+    for (unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        ConcurrentCuckooFilter<string, MurMurHash3, RabinFingerprint> cuckoo(keys.size() / 4, 500, 4);
+        for (size_t i = 0; i < half; i++) {
+            cuckoo.insert(keys[i]);
+        }
+
+        atomic<bool> running(true);
+        atomic<uint64_t> lookups(0);
+        uint64_t updates = 0;
+
+        vector<thread> readers;
+        for (unsigned t = 0; t < n_threads; t++) {
+            readers.emplace_back([&, t]() {
+                uint64_t count = 0;
+                for (size_t i = t; running.load(std::memory_order_relaxed); i = (i + 1) % keys.size()) {
+                    cuckoo.lookup(keys[i]);
+                    count++;
+                }
+                lookups.fetch_add(count);
+            });
+        }
+
+        thread writer([&]() {
+            for (size_t i = 0; running.load(std::memory_order_relaxed); i = (i + 1) % half) {
+                cuckoo.remove(keys[i]);
+                cuckoo.insert(keys[i + half]);
+                cuckoo.remove(keys[i + half]);
+                cuckoo.insert(keys[i]);
+                updates += 4;
+            }
+        });
+
+        steady_clock::time_point start = steady_clock::now();
+        this_thread::sleep_for(milliseconds(500));
+        running.store(false);
+
+        for (thread& reader : readers) {
+            reader.join();
+        }
+        writer.join();
+
+        double secs = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e9;
+        std::cout << n_threads << "\t" << lookups.load() / secs << "\t\t" << updates / secs << "\n";
+    }
+}
+
+void benchmark_dynamic(const string& filename, uint64_t limit) {
+    vector<string> keys = read_keys(filename, limit);
+    DynamicCuckooFilter<string, MurMurHash3, RabinFingerprint> cuckoo(256, 500, 4);
+
+    std::cout << "\nkeys\tfilters\tbytes\t\tbytes/key\tload factor\n";
+
+    uint64_t report = 1024;
+    for (size_t i = 0; i < keys.size(); i++) {
+        cuckoo.insert(keys[i]);
+
+        if (i + 1 == report or i + 1 == keys.size()) {
+            std::cout << cuckoo.num_keys() << "\t" << cuckoo.num_filters() << "\t" << cuckoo.size_in_bytes() << "\t\t";
+            std::cout << (double) cuckoo.size_in_bytes() / cuckoo.num_keys() << "\t\t" << 100 * cuckoo.load_factor() << " %\n";
+            report *= 2;
+        }
+    }
+
+    for (size_t i = 0; i < keys.size() - keys.size() / 16; i++) {
+        cuckoo.remove(keys[i]);
+    }
+
+    std::cout << cuckoo.num_keys() << "\t" << cuckoo.num_filters() << "\t" << cuckoo.size_in_bytes() << "\t\t";
+    std::cout << (double) cuckoo.size_in_bytes() / cuckoo.num_keys() << "\t\t" << 100 * cuckoo.load_factor() << " % (after deletions)\n";
+}
+
+void benchmark_adaptive(const string& filename, uint64_t limit) {
+    vector<string> keys = read_keys(filename, limit);
+    unordered_set<string> members(keys.begin(), keys.end());
+    uint64_t rows = 1;
+    while (4 * rows < keys.size()) {
+        rows <<= 1;
+    }
+
+    AdaptiveCuckooFilter<string, MurMurHash3> cuckoo(rows, 500, 4);
+    for (const string& key : keys) {
+        cuckoo.insert(key);
+    }
+
+    const size_t n_candidates = 1 << 17, n_queries = 1 << 20;
+    vector<string> candidates;
+    vector<double> weights;
+    for (size_t i = 0; i < n_candidates; i++) {
+        candidates.push_back("#" + to_string(i));
+        weights.push_back(1.0 / (i + 1));
+    }
+
+    mt19937 gen(42);
+    discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+    vector<size_t> stream(n_queries);
+    for (size_t i = 0; i < n_queries; i++) {
+        stream[i] = zipf(gen);
+    }
+
+    std::cout << "\nload factor\t: " << 100 * cuckoo.load_factor() << " %";
+    std::cout << "\nqueries\t\t: " << n_queries << " over " << n_candidates << " non-members (zipf)\n";
+    std::cout << "\nround\tbackend calls\tadaptations\n";
+
+    const char* rounds[3] = {"before", "during", "after"};
+    for (size_t round = 0; round < 3; round++) {
+        uint64_t backend_calls = 0;
+        for (size_t q : stream) {
+            if (cuckoo.lookup(candidates[q])) {
+                backend_calls++;
+
+                if (round > 0 and not members.count(candidates[q])) {
+                    cuckoo.report_false_positive(candidates[q]);
+                }
+            }
+        }
+
+        std::cout << rounds[round] << "\t" << backend_calls << "\t\t" << cuckoo.num_adaptations() << "\n";
+    }
+
+    uint64_t missing = 0;
+    for (const string& key : keys) {
+        missing += not cuckoo.lookup(key);
+    }
+
+    std::cout << "\nmissing members after adaptation: " << missing << "\n";
+}
+
+template <class Filter>
+void report_memory(Filter& cuckoo, const char* name, const vector<string>& keys) {
+    using namespace std::chrono;
+
+    for (const string& key : keys) {
+        cuckoo.insert(key);
+    }
+
+    steady_clock::time_point start = steady_clock::now();
+    uint64_t hits = 0;
+    for (const string& key : keys) {
+        hits += cuckoo.lookup(key);
+    }
+    double positive = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+    start = steady_clock::now();
+    uint64_t false_hits = 0;
+    for (const string& key : keys) {
+        false_hits += cuckoo.lookup("#" + key);
+    }
+    double negative = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+    std::cout << name << "\t" << cuckoo.size_in_bytes() << "\t\t" << (double) cuckoo.size_in_bytes() / cuckoo.num_keys() << "\t\t";
+    std::cout << hits << "\t" << 100.0 * false_hits / keys.size() << " %\t\t" << positive << " / " << negative << "\n";
+}
+
+void benchmark_morton(const string& filename, uint64_t limit) {
+    vector<string> keys = read_keys(filename, limit);
+
+    CuckooFilterLL<string, MurMurHash3, RabinFingerprint> cuckoo_ll(keys.size(), 500);
+    CuckooFilterHL<string, MurMurHash3, RabinFingerprint> cuckoo_hl(keys.size() / 2, 500, 4);
+    MortonCuckooFilter<string, MurMurHash3, RabinFingerprint> cuckoo_morton(keys.size() / 0.75, 500);
+
+    std::cout << "\nfilter\tbytes\t\tbytes/key\thits\tfalse positives\tlookup ns (member / non-member)\n";
+    report_memory(cuckoo_ll, "LL", keys);
+    report_memory(cuckoo_hl, "HL", keys);
+    report_memory(cuckoo_morton, "morton", keys);
+    std::cout << "\nmorton load factor: " << 100 * cuckoo_morton.load_factor() << " %, failed inserts: " << cuckoo_morton.num_failures() << "\n";
+}
+
+void benchmark_sharded(const string& filename, uint64_t limit) {
+    using namespace std::chrono;
+
+    vector<string> keys = read_keys(filename, limit);
+    const unsigned max_threads = max(1u, thread::hardware_concurrency());
+
+    CuckooFilterHL<string, MurMurHash3, RabinFingerprint> single(keys.size() / 2, 500, 4);
+    steady_clock::time_point start = steady_clock::now();
+    for (const string& key : keys) {
+        single.insert(key);
+    }
+    double elapsed = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+    std::cout << "\nthreads\tshards\tload time\tkeys\t\tfailed\n";
+    std::cout << "-\t1\t" << elapsed << " ms\t" << single.num_keys() << "\t\t" << single.num_failures() << "\n";
+
+    for (unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        ShardedCuckooFilter<string, MurMurHash3, RabinFingerprint> sharded(keys.size() / 2, 500, 4 * max_threads, 4);
+
+        start = steady_clock::now();
+        sharded.bulk_load(keys.data(), keys.size(), n_threads);
+        elapsed = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+        uint64_t missing = 0;
+        for (const string& key : keys) {
+            missing += not sharded.lookup(key);
+        }
+
+        std::cout << n_threads << "\t" << sharded.num_shards() << "\t" << elapsed << " ms\t" << sharded.num_keys() << "\t\t" << sharded.num_failures();
+        std::cout << (missing > sharded.num_failures() ? " (lookups missing keys)" : "") << "\n";
+    }
+}
+
+void benchmark_persistence(const string& filename, uint64_t limit) {
+    using namespace std::chrono;
+
+    vector<string> keys = read_keys(filename, limit);
+    const string path = filename + ".cuckoo";
+
+    steady_clock::time_point start = steady_clock::now();
+    CuckooFilterHL<string, MurMurHash3, RabinFingerprint> cuckoo(keys.size() / 2, 500, 4);
+    for (const string& key : keys) {
+        cuckoo.insert(key);
+    }
+    for (size_t i = 0; i < keys.size() / 4; i++) {
+        cuckoo.remove(keys[i]);
+    }
+    double rebuild = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+    start = steady_clock::now();
+    cuckoo.save(path);
+    double saved = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+    start = steady_clock::now();
+    CuckooFilterHL<string, MurMurHash3, RabinFingerprint> mapped(path);
+    double opened = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+    uint64_t mismatches = 0;
+    for (const string& key : keys) {
+        mismatches += mapped.lookup(key) != cuckoo.lookup(key);
+    }
+
+    CuckooFilterHL<string, MurMurHash3, RabinFingerprint> private_copy(path, _CUCKOOFILTER_OPEN_COPY_ON_WRITE);
+    uint64_t removed = private_copy.remove_batch(keys.data() + keys.size() / 4, keys.size() / 4);
+
+    std::cout << "\nrebuild from dictionary\t: " << rebuild << " ms";
+    std::cout << "\nsave\t\t\t: " << saved << " ms (" << cuckoo.size_in_bytes() << " bytes)";
+    std::cout << "\nmapped open\t\t: " << opened << " ms (" << mapped.num_keys() << " keys, " << mismatches << " mismatched lookups)";
+    std::cout << "\ncopy-on-write removes\t: " << removed << " (read-only insert status: " << (int) mapped.insert(keys[0]) << ")\n";
+
+    std::remove(path.c_str());
+}
+
+typedef pair<uint32_t, uint32_t> BreachInfo;
+
+const BreachInfo* map_find(CuckooHashMap<string, BreachInfo, MurMurHash3>& table, const string& key) {
+    return table.find(key);
+}
+
+const BreachInfo* map_find(unordered_map<string, BreachInfo>& table, const string& key) {
+    unordered_map<string, BreachInfo>::iterator it = table.find(key);
+    return it == table.end() ? nullptr : &it->second;
+}
+
+template <class Map>
+void report_map(Map& table, const char* name, const vector<string>& keys, const vector<string>& misses) {
+    using namespace std::chrono;
+
+    steady_clock::time_point start = steady_clock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        table.insert_or_assign(keys[i], BreachInfo(i % 64, i));
+    }
+    double inserted = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+    start = steady_clock::now();
+    uint64_t checksum = 0;
+    for (const string& key : keys) {
+        if (const BreachInfo* info = map_find(table, key)) {
+            checksum += info->second;
+        }
+    }
+    double hits = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+    start = steady_clock::now();
+    uint64_t found = 0;
+    for (const string& key : misses) {
+        found += map_find(table, key) != nullptr;
+    }
+    double miss = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) misses.size();
+
+    start = steady_clock::now();
+    for (const string& key : keys) {
+        table.erase(key);
+    }
+    double erased = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+    std::cout << name << "\t" << inserted << "\t\t" << hits << "\t\t" << miss << "\t\t" << erased << "\t\t" << checksum + found << "\n";
+}
+
+void benchmark_hashmap(const string& filename, uint64_t limit) {
+    vector<string> keys = read_keys(filename, limit);
+    vector<string> misses;
+    for (const string& key : keys) {
+        misses.push_back("#" + key);
+    }
+
+    CuckooHashMap<string, BreachInfo, MurMurHash3> cuckoo_map;
+    unordered_map<string, BreachInfo> std_map;
+
+    std::cout << "\nmap\t\tinsert ns\thit ns\t\tmiss ns\t\terase ns\tchecksum\n";
+    report_map(cuckoo_map, "cuckoo\t", keys, misses);
+    report_map(std_map, "unordered_map", keys, misses);
+}
+
+void benchmark_probe(const string& filename, uint64_t limit) {
+    using namespace std::chrono;
+
+    vector<string> keys = read_keys(filename, limit);
+    uint64_t rows = 1;
+    while (8 * rows <= keys.size()) {
+        rows <<= 1;
+    }
+    bool* results = new bool[keys.size()];
+
+    const double loads[2] = {0.50, 0.95};
+    for (double load : loads) {
+        CuckooFilterHL<string, MurMurHash3, RabinFingerprint> cuckoo(rows, 500, 4, _TABLEMEMORY_TRANSPARENT_HUGE_PAGES);
+        const uint64_t slots = cuckoo.size_in_bytes() / sizeof(uint64_t);
+
+        for (size_t i = 0; i < keys.size() and cuckoo.num_keys() < load * slots; i++) {
+            cuckoo.insert(keys[i]);
+        }
+
+        const double filled = 100.0 * cuckoo.num_keys() / slots;
+
+        steady_clock::time_point start = steady_clock::now();
+        uint64_t hits = 0;
+        for (size_t i = 0; i < keys.size(); i++) {
+            hits += cuckoo.lookup(keys[i]);
+        }
+        double single = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+        start = steady_clock::now();
+        cuckoo.lookup_batch(keys.data(), keys.size(), results);
+        double batch = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+        start = steady_clock::now();
+        uint64_t batch_hits = cuckoo.contains_count(keys.data(), keys.size());
+        double counted = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+        CuckooFilterHL<string, MurMurHash3, RabinFingerprint> cuckoo_copy(cuckoo);
+
+        start = steady_clock::now();
+        for (size_t i = 0; i < keys.size(); i++) {
+            cuckoo.remove(keys[i]);
+        }
+        double removal = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+        start = steady_clock::now();
+        cuckoo_copy.remove_batch(keys.data(), keys.size());
+        double batch_removal = duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double) keys.size();
+
+        std::cout << "\nload factor\t\t\t: " << filled << " %";
+        std::cout << "\npositive lookups\t\t: " << hits << " / " << keys.size() << " (batched: " << batch_hits << ")";
+        std::cout << "\naverage lookup time\t\t: " << single << " ns";
+        std::cout << "\naverage batched lookup time\t: " << batch << " ns";
+        std::cout << "\naverage batched count time\t: " << counted << " ns";
+        std::cout << "\naverage removal time\t\t: " << removal << " ns";
+        std::cout << "\naverage batched removal time\t: " << batch_removal << " ns\n";
+    }
+
+    delete[] results;
+}
+
+class MappedDictionary {
+    private:
+        const char* data;
+        size_t length;
+
+    public:
+        explicit MappedDictionary(const string& filename) : data(nullptr), length(0) {
+            int fd = open(filename.c_str(), O_RDONLY);
+            struct stat info;
+            if (fd < 0 or fstat(fd, &info)) {
+                throw fstream::failure("failed to open file");
+            }
+
+            length = info.st_size;
+            void* mapped = length ? mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+            close(fd);
+
+            if (mapped == MAP_FAILED) {
+                throw fstream::failure("failed to map file");
+            }
+
+            data = (const char*) mapped;
+        }
+
+        MappedDictionary(const MappedDictionary&) = delete;
+
+        MappedDictionary& operator=(const MappedDictionary&) = delete;
+
+        ~MappedDictionary(void) {
+            if (data) {
+                munmap((void*) data, length);
+            }
+        }
+
+        template <class Visitor>
+        uint64_t for_each(uint64_t limit, Visitor visit) const {
+            uint64_t count = 0;
+            for (size_t pos = 0; pos < length and count < limit; count++) {
+                const char* end = (const char*) memchr(data + pos, '\n', length - pos);
+                const size_t line_end = end ? end - data : length;
+
+                visit(string_view(data + pos, line_end - pos));
+                pos = line_end + 1;
+            }
+
+            return count;
+        }
+};
+
+void report_allocations(const char* name, uint64_t allocations, double elapsed, uint64_t keys) {
+    std::cout << name << "\t" << allocations << "\t\t" << (double) allocations / keys << "\t\t" << elapsed / keys << " ns\n";
+}
+
+template <class Visitor>
+void measure_allocations(const char* name, const vector<string_view>& keys, Visitor visit) {
+    using namespace std::chrono;
+
+    steady_clock::time_point start = steady_clock::now();
+    AllocationScope scope;
+    for (string_view key : keys) {
+        visit(key);
+    }
+
+    report_allocations(name, scope.allocations(), duration_cast<nanoseconds>(steady_clock::now() - start).count(), keys.size());
+}
+
+void compare_key_paths(const char* label, const vector<string_view>& keys) {
+    CuckooFilterHL<string, MurMurHash3, RabinFingerprint> copied(keys.size() / 2 + 1, 500, 4);
+    CuckooFilterHL<string_view, MurMurHash3, RabinFingerprint> viewed(keys.size() / 2 + 1, 500, 4);
+    uint64_t hits = 0, view_hits = 0;
+
+    std::cout << "\n" << label << "\npath\t\t\tallocations\tper key\t\ttime per key\n";
+
+    measure_allocations("string copy insert", keys, [&](string_view key) {
+        copied.insert(string(key));
+    });
+
+    measure_allocations("string copy lookup", keys, [&](string_view key) {
+        hits += copied.lookup(string(key));
+    });
+
+    measure_allocations("mapped view insert", keys, [&](string_view key) {
+        viewed.insert(key);
+    });
+
+    measure_allocations("mapped view lookup", keys, [&](string_view key) {
+        view_hits += viewed.lookup(key);
+    });
+
+    std::cout << "\npositive lookups: " << hits << " (string copy) / " << view_hits << " (string_view) of " << keys.size() << "\n";
+}
+
+void benchmark_zero_copy(const string& filename, uint64_t limit) {
+    MappedDictionary dictionary(filename);
+    vector<string_view> keys;
+    dictionary.for_each(limit, [&](string_view key) {
+        keys.push_back(key);
+    });
+
+    compare_key_paths("dictionary keys", keys);
+
+    const string salt = "#zero-copy-salt#";
+    string arena;
+    for (string_view key : keys) {
+        arena.append(key).append(salt);
+    }
+
+    vector<string_view> long_keys;
+    size_t pos = 0;
+    for (string_view key : keys) {
+        long_keys.emplace_back(arena.data() + pos, key.size() + salt.size());
+        pos += key.size() + salt.size();
+    }
+
+    compare_key_paths("salted keys (longer than the small-string buffer)", long_keys);
+}
+
 int main(void) {
     string filename;
     cout << "enter dictionary path: ";
@@ -242,13 +837,31 @@ int main(void) {
         cout << "custom load factor (low load cuckoo filter): ";
         cin >> load_factor;
 
-        CuckooFilterLL<string, MurMurHash3, RabinFingerprint> cuckoo_ll(ll_limit, 500, load_factor);
-        CuckooFilterHL<string, MurMurHash3, RabinFingerprint> cuckoo_hl(hl_limit, 500, 2);
+        CuckooFilterLL<string, MurMurHash3, RabinFingerprint> cuckoo_ll(ll_limit, 500, load_factor, _TABLEMEMORY_TRANSPARENT_HUGE_PAGES);
+        CuckooFilterHL<string, MurMurHash3, RabinFingerprint> cuckoo_hl(hl_limit, 500, 2, _TABLEMEMORY_TRANSPARENT_HUGE_PAGES);
 
         cout << "\n------------------ LOW LOAD CUCKOO FILTER ------------------\n";
         benchmark(cuckoo_ll, filename, ll_limit);
         cout << "\n------------------ HIGH LOAD CUCKOO FILTER ------------------\n";
         benchmark(cuckoo_hl, filename, hl_limit);
+        cout << "\n------------------ BUCKET PROBE ------------------\n";
+        benchmark_probe(filename, hl_limit);
+        cout << "\n------------------ CONCURRENT CUCKOO FILTER ------------------\n";
+        benchmark_concurrent(filename, hl_limit);
+        cout << "\n------------------ DYNAMIC CUCKOO FILTER ------------------\n";
+        benchmark_dynamic(filename, hl_limit);
+        cout << "\n------------------ ADAPTIVE CUCKOO FILTER ------------------\n";
+        benchmark_adaptive(filename, hl_limit);
+        cout << "\n------------------ MORTON CUCKOO FILTER ------------------\n";
+        benchmark_morton(filename, hl_limit);
+        cout << "\n------------------ SHARDED CUCKOO FILTER ------------------\n";
+        benchmark_sharded(filename, hl_limit);
+        cout << "\n------------------ PERSISTENCE ------------------\n";
+        benchmark_persistence(filename, hl_limit);
+        cout << "\n------------------ CUCKOO HASH MAP ------------------\n";
+        benchmark_hashmap(filename, hl_limit);
+        cout << "\n------------------ ZERO-COPY KEYS ------------------\n";
+        benchmark_zero_copy(filename, hl_limit);
         return 0;
     }
 
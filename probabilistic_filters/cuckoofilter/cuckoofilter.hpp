@@ -1,6 +1,62 @@
 #pragma once
 
 #include <random>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include "tablememory.hpp"
+#include "bucketprobe.hpp"
+#include "cuckoofile.hpp"
+
+#ifndef _CUCKOOFILTER_INSERTED
+    #define _CUCKOOFILTER_INSERTED 0
+#endif
+
+#ifndef _CUCKOOFILTER_STASHED
+    #define _CUCKOOFILTER_STASHED 1
+#endif
+
+#ifndef _CUCKOOFILTER_FULL
+    #define _CUCKOOFILTER_FULL 2
+#endif
+
+#ifndef _CUCKOOFILTER_READ_ONLY
+    #define _CUCKOOFILTER_READ_ONLY 3
+#endif
+
+#ifndef _CUCKOOFILTER_OPEN_READ_ONLY
+    #define _CUCKOOFILTER_OPEN_READ_ONLY 0
+#endif
+
+#ifndef _CUCKOOFILTER_OPEN_COPY_ON_WRITE
+    #define _CUCKOOFILTER_OPEN_COPY_ON_WRITE 1
+#endif
+
+#ifndef _CUCKOOFILTER_STASH_SIZE
+    #define _CUCKOOFILTER_STASH_SIZE 8
+#endif
+
+#ifndef _CUCKOOFILTER_BATCH_SIZE
+    #define _CUCKOOFILTER_BATCH_SIZE 16
+#endif
+
+#ifndef _CUCKOOFILTER_LL_BLOCK_ROWS
+    #define _CUCKOOFILTER_LL_BLOCK_ROWS 4
+#endif
+
+struct CuckooFilterStats {
+    std::vector<uint64_t> kick_chains;
+    std::vector<uint64_t> bucket_occupancy;
+    uint64_t stashed;
+    uint64_t failed;
+    double load_at_first_failure;
+};
+
+template <typename _Tp, class HashFamily, class FingerprintFamily> class DynamicCuckooFilter;
+
+template <typename _Tp, class HashFamily, class FingerprintFamily> class ShardedCuckooFilter;
 
 template <typename _Tp, class HashFamily, class FingerprintFamily>
 class CuckooFilterLL {
@@ -10,17 +66,48 @@ class CuckooFilterLL {
         const size_t n_buckets;
         uint64_t key_count;
 
-        uint64_t** table;
+        uint64_t* table;
+        uint8_t pages;
+
+        uint64_t stash[_CUCKOOFILTER_STASH_SIZE];
+        uint32_t stash_hash[_CUCKOOFILTER_STASH_SIZE];
+        size_t stash_count;
+        uint64_t failed_count;
+        bool read_only;
+
+        std::vector<uint64_t> kick_histogram;
+        uint64_t stashed_total;
+        double first_failure_load;
+
+        std::vector<std::pair<uint64_t*, uint64_t>> kick_log;
 
         std::random_device prng;
 
         const HashFamily hasher;
         const FingerprintFamily fingerprint;
 
-        void insert_util(uint64_t, uint32_t, size_t, size_t);
+        uint32_t alt_index(uint64_t, uint32_t) const noexcept;
+
+        uint8_t insert_util(uint64_t, uint32_t, size_t) noexcept;
+
+        uint8_t stash_or_rollback(uint64_t, uint32_t) noexcept;
+
+        void retry_stash(void) noexcept;
+
+        bool stash_contains(uint64_t) const noexcept;
+
+        bool lookup_util(uint64_t, uint32_t, uint32_t) const noexcept;
+
+        bool remove_util(uint64_t, uint32_t, uint32_t) noexcept;
+
+        void prepare_batch(const _Tp*, const size_t, uint64_t*, uint32_t*, uint32_t*) const noexcept;
+
+        CuckooFilterLL(const CuckooFileHeader&, const std::string&, const uint8_t);
 
     public:
-        explicit CuckooFilterLL(const uint64_t, const uint32_t, const double = 0.25);
+        explicit CuckooFilterLL(const uint64_t, const uint32_t, const double = 0.25, const uint8_t = _TABLEMEMORY_DEFAULT_PAGES);
+
+        explicit CuckooFilterLL(const std::string&, const uint8_t = _CUCKOOFILTER_OPEN_READ_ONLY);
 
         CuckooFilterLL(const CuckooFilterLL&);
 
@@ -28,15 +115,31 @@ class CuckooFilterLL {
 
         ~CuckooFilterLL(void);
 
-        void insert(const _Tp);
+        uint8_t insert(const _Tp&) noexcept;
+
+        bool lookup(const _Tp&) const noexcept;
+
+        void lookup_batch(const _Tp*, const size_t, bool*) const noexcept;
+
+        uint64_t contains_count(const _Tp*, const size_t) const noexcept;
 
-        bool lookup(const _Tp) const noexcept;
+        bool remove(const _Tp&) noexcept;
 
-        bool remove(const _Tp) noexcept;
+        uint64_t remove_batch(const _Tp*, const size_t) noexcept;
+
+        void save(const std::string&) const;
 
         constexpr double load_factor(void) const noexcept;
 
         constexpr uint64_t num_keys(void) const noexcept;
+
+        constexpr uint64_t num_stashed(void) const noexcept;
+
+        constexpr uint64_t num_failures(void) const noexcept;
+
+        constexpr bool is_read_only(void) const noexcept;
+
+        CuckooFilterStats stats(void) const;
         
         constexpr uint64_t size_in_bytes(void) const noexcept;
 };
@@ -45,25 +148,59 @@ template <typename _Tp, class HashFamily, class FingerprintFamily>
 class CuckooFilterHL {
     private:
         const uint64_t size;
+        const uint64_t mask;
         const uint32_t threshold;
         const size_t n_buckets;
         uint64_t key_count;
 
-        uint64_t** table;
+        uint64_t* table;
+        uint8_t pages;
+
+        uint64_t stash[_CUCKOOFILTER_STASH_SIZE];
+        uint32_t stash_hash[_CUCKOOFILTER_STASH_SIZE];
+        size_t stash_count;
+        uint64_t failed_count;
+        bool read_only;
+
+        std::vector<uint64_t> kick_histogram;
+        uint64_t stashed_total;
+        double first_failure_load;
+
+        std::vector<std::pair<uint64_t*, uint64_t>> kick_log;
 
         std::random_device prng;
 
         const HashFamily hasher;
         const FingerprintFamily fingerprint;
 
-        void insert_util(uint64_t, uint32_t, size_t, size_t);
+        static uint64_t round_pow2(uint64_t) noexcept;
+
+        uint32_t alt_index(uint64_t, uint32_t) const noexcept;
 
-        bool lookup_util(uint64_t, uint32_t, size_t, size_t) const noexcept;
+        uint8_t insert_util(uint64_t, uint32_t, size_t) noexcept;
 
-        bool remove_util(uint64_t, uint32_t, size_t, size_t) noexcept;
+        uint8_t stash_or_rollback(uint64_t, uint32_t) noexcept;
+
+        void retry_stash(void) noexcept;
+
+        bool stash_contains(uint64_t) const noexcept;
+
+        bool lookup_util(uint64_t, uint32_t, uint32_t) const noexcept;
+
+        bool remove_util(uint64_t, uint32_t, uint32_t) noexcept;
+
+        void prepare_batch(const _Tp*, const size_t, uint64_t*, uint32_t*, uint32_t*) const noexcept;
+
+        template <typename, class, class> friend class DynamicCuckooFilter;
+
+        template <typename, class, class> friend class ShardedCuckooFilter;
+
+        CuckooFilterHL(const CuckooFileHeader&, const std::string&, const uint8_t);
 
     public:
-        explicit CuckooFilterHL(const uint64_t, const uint32_t, const size_t = 2);
+        explicit CuckooFilterHL(const uint64_t, const uint32_t, const size_t = 2, const uint8_t = _TABLEMEMORY_DEFAULT_PAGES);
+
+        explicit CuckooFilterHL(const std::string&, const uint8_t = _CUCKOOFILTER_OPEN_READ_ONLY);
 
         CuckooFilterHL(const CuckooFilterHL&);
 
@@ -71,141 +208,254 @@ class CuckooFilterHL {
 
         ~CuckooFilterHL(void);
 
-        void insert(const _Tp);
+        uint8_t insert(const _Tp&) noexcept;
 
-        bool lookup(const _Tp) const noexcept;
+        bool lookup(const _Tp&) const noexcept;
 
-        bool remove(const _Tp) noexcept;
+        void lookup_batch(const _Tp*, const size_t, bool*) const noexcept;
+
+        uint64_t contains_count(const _Tp*, const size_t) const noexcept;
+
+        bool remove(const _Tp&) noexcept;
+
+        uint64_t remove_batch(const _Tp*, const size_t) noexcept;
+
+        void save(const std::string&) const;
 
         constexpr double load_factor(void) const noexcept;
 
         constexpr uint64_t num_keys(void) const noexcept;
+
+        constexpr uint64_t num_stashed(void) const noexcept;
+
+        constexpr uint64_t num_failures(void) const noexcept;
+
+        constexpr bool is_read_only(void) const noexcept;
+
+        CuckooFilterStats stats(void) const;
         
         constexpr uint64_t size_in_bytes(void) const noexcept;
 };
 
 template <typename _Tp, class HF, class FF>
-CuckooFilterLL<_Tp, HF, FF>::CuckooFilterLL(const uint64_t size, const uint32_t relocation_threshold, const double load_factor)
-    : threshold(relocation_threshold), n_buckets(2),
-    key_count(0), hasher(), fingerprint() {
+CuckooFilterLL<_Tp, HF, FF>::CuckooFilterLL(const uint64_t size, const uint32_t relocation_threshold, const double load_factor, const uint8_t pages)
+    : threshold(relocation_threshold), n_buckets(2), key_count(0),
+    pages(pages), stash_count(0), failed_count(0), read_only(false),
+    kick_histogram(relocation_threshold), stashed_total(0), first_failure_load(0), hasher(), fingerprint() {
     if (load_factor <= 0 or load_factor > 1) {
         std::string exc_msg = "invalid load factor: " + std::to_string(load_factor);
         throw std::invalid_argument(exc_msg.c_str());
     }
     this->size = ceil(size / load_factor);
+    this->size += (_CUCKOOFILTER_LL_BLOCK_ROWS - this->size % _CUCKOOFILTER_LL_BLOCK_ROWS) % _CUCKOOFILTER_LL_BLOCK_ROWS;
+    table = (uint64_t*) TableMemory::allocate(size_in_bytes(), this->pages);
+    kick_log.reserve(threshold);
+}
 
-    table = new uint64_t*[n_buckets];
-    for (size_t i = 0; i < n_buckets; i++) {
-        table[i] = new uint64_t[this->size];
+template <typename _Tp, class HF, class FF>
+CuckooFilterLL<_Tp, HF, FF>::CuckooFilterLL(const std::string& path, const uint8_t mode)
+    : CuckooFilterLL(CuckooFile::read_header(path, _CUCKOOFILE_KIND_LL, HF::family_id, FF::family_id), path, mode) {}
+
+template <typename _Tp, class HF, class FF>
+CuckooFilterLL<_Tp, HF, FF>::CuckooFilterLL(const CuckooFileHeader& header, const std::string& path, const uint8_t mode)
+    : size(header.size), threshold(header.threshold), n_buckets(header.n_buckets), key_count(header.key_count),
+    table(nullptr), pages(_TABLEMEMORY_DEFAULT_PAGES),
+    stash_count(header.stash_count), failed_count(header.failed_count), read_only(mode == _CUCKOOFILTER_OPEN_READ_ONLY),
+    kick_histogram(header.threshold), stashed_total(header.stash_count), first_failure_load(0), hasher(), fingerprint() {
+
+    if (size % _CUCKOOFILTER_LL_BLOCK_ROWS) {
+        throw std::runtime_error("corrupt cuckoo filter file: " + path);
+    }
+
+    for (size_t i = 0; i < stash_count; i++) {
+        stash[i] = header.stash[i];
+        stash_hash[i] = header.stash_hash[i];
     }
+
+    table = (uint64_t*) TableMemory::map(path, header.table_offset, size_in_bytes(), mode == _CUCKOOFILTER_OPEN_COPY_ON_WRITE, pages);
+    kick_log.reserve(threshold);
 }
 
 template <typename _Tp, class HF, class FF>
-CuckooFilterLL<_Tp, HF, FF>::~CuckooFilterLL(void) {
-    for (size_t i = 0; i < n_buckets; i++) {
-        delete[] table[i];
+void CuckooFilterLL<_Tp, HF, FF>::save(const std::string& path) const {
+    CuckooFileHeader header = CuckooFile::header(_CUCKOOFILE_KIND_LL, HF::family_id, FF::family_id);
+    header.size = size;
+    header.n_buckets = n_buckets;
+    header.threshold = threshold;
+    header.key_count = key_count;
+    header.failed_count = failed_count;
+    header.stash_count = stash_count;
+    header.table_bytes = size_in_bytes();
+
+    for (size_t i = 0; i < stash_count; i++) {
+        header.stash[i] = stash[i];
+        header.stash_hash[i] = stash_hash[i];
     }
-    delete[] table;
+
+    CuckooFile::save(path, header, table);
+}
+
+template <typename _Tp, class HF, class FF>
+CuckooFilterLL<_Tp, HF, FF>::~CuckooFilterLL(void) {
+    TableMemory::release(table, size_in_bytes(), pages);
 }
 
 template <typename _Tp, class HF, class FF>
 CuckooFilterLL<_Tp, HF, FF>::CuckooFilterLL(const CuckooFilterLL& cf_ll)
     : size(cf_ll.size), threshold(cf_ll.threshold),
-    n_buckets(cf_ll.n_buckets), key_count(cf_ll.key_count), hasher(), fingerprint() {
+    n_buckets(cf_ll.n_buckets), key_count(cf_ll.key_count), pages(cf_ll.pages), stash_count(cf_ll.stash_count),
+    failed_count(cf_ll.failed_count), read_only(false),
+    kick_histogram(cf_ll.kick_histogram), stashed_total(cf_ll.stashed_total), first_failure_load(cf_ll.first_failure_load), hasher(), fingerprint() {
     
-    table = new uint64_t*[n_buckets];
-    for (size_t i = 0; i < n_buckets; i++) {
-        table[i] = new uint64_t[size];
-
-        for (size_t j = 0; j < size; j++) {
-            table[i][j] = cf_ll.table[i][j];
-        }
+    for (size_t i = 0; i < stash_count; i++) {
+        stash[i] = cf_ll.stash[i];
+        stash_hash[i] = cf_ll.stash_hash[i];
     }
+
+    table = (uint64_t*) TableMemory::allocate(size_in_bytes(), pages);
+    std::memcpy(table, cf_ll.table, size_in_bytes());
+    kick_log.reserve(threshold);
 }
 
 template <typename _Tp, class HF, class FF>
 CuckooFilterLL<_Tp, HF, FF>& CuckooFilterLL<_Tp, HF, FF>::operator=(const CuckooFilterLL& cf_ll) {
-    for (size_t i = 0; i < n_buckets; i++) {
-        delete[] table[i];
-    }
-    delete[] table;
+    TableMemory::release(table, size_in_bytes(), pages);
 
     size = cf_ll.size;
     threshold = cf_ll.threshold;
     n_buckets = cf_ll.n_buckets;
     key_count = cf_ll.key_count;
+    stash_count = cf_ll.stash_count;
+    failed_count = cf_ll.failed_count;
+    read_only = false;
+    kick_histogram = cf_ll.kick_histogram;
+    stashed_total = cf_ll.stashed_total;
+    first_failure_load = cf_ll.first_failure_load;
+    pages = cf_ll.pages;
     hasher = cf_ll.hasher;
     fingerprint = cf_ll.fingerprint;
 
-    table = new uint64_t*[n_buckets];
-    for (size_t i = 0; i < n_buckets; i++) {
-        table[i] = new uint64_t[size];
-
-        for (size_t j = 0; j < size; j++) {
-            table[i][j] = cf_ll.table[i][j];
-        }
+    for (size_t i = 0; i < stash_count; i++) {
+        stash[i] = cf_ll.stash[i];
+        stash_hash[i] = cf_ll.stash_hash[i];
     }
 
+    table = (uint64_t*) TableMemory::allocate(size_in_bytes(), pages);
+    std::memcpy(table, cf_ll.table, size_in_bytes());
+
     return *this;
 }
 
 template <typename _Tp, class HF, class FF>
-void CuckooFilterLL<_Tp, HF, FF>::insert_util(uint64_t fp, uint32_t _hash, size_t bucket_id, size_t count) {
-    if (count == threshold) {
-        std::string exc_msg = "relocation threshold reached: " + std::to_string(threshold);
-        throw std::overflow_error(exc_msg.c_str());
+uint8_t CuckooFilterLL<_Tp, HF, FF>::stash_or_rollback(uint64_t fp, uint32_t _hash) noexcept {
+    if (stash_count < _CUCKOOFILTER_STASH_SIZE) {
+        stash[stash_count] = fp;
+        stash_hash[stash_count++] = _hash;
+        stashed_total++;
+        return _CUCKOOFILTER_STASHED;
     }
 
-    else if (_hash >= size) {
-        std::string exc_msg = "hash: " + std::to_string(_hash);
-        exc_msg += " is out of bucket range: " + std::to_string(size - 1);
-        throw std::out_of_range(exc_msg.c_str());
+    while (not kick_log.empty()) {
+        *kick_log.back().first = kick_log.back().second;
+        kick_log.pop_back();
     }
 
-    else if (not table[bucket_id][_hash]) {
-        table[bucket_id][_hash] = fp;
+    if (not failed_count) {
+        first_failure_load = load_factor();
     }
 
-    else {
-        size_t id = (bucket_id + 1) % n_buckets;
-        uint32_t alt_hash = _hash ^ (hasher(fp) % size);
+    failed_count++;
+    return _CUCKOOFILTER_FULL;
+}
 
-        if (not table[id][alt_hash]) {
-            table[id][alt_hash] = fp;
+template <typename _Tp, class HF, class FF>
+void CuckooFilterLL<_Tp, HF, FF>::retry_stash(void) noexcept {
+    for (size_t i = 0; i < stash_count; ) {
+        uint64_t fp = stash[i];
+        uint32_t _hash = stash_hash[i];
+        uint32_t alt_hash = alt_index(fp, _hash);
+
+        if (not table[2 * _hash]) {
+            table[2 * _hash] = fp;
         }
 
-        else {
-            id = prng() % n_buckets;
-            uint32_t target_hash = (id == 0) ? _hash : alt_hash;
-            uint32_t relocate_fp = table[id][target_hash];
+        else if (not table[2 * alt_hash + 1]) {
+            table[2 * alt_hash + 1] = fp;
+        }
 
-            table[id][target_hash] = fp;
-            target_hash = target_hash ^ (hasher(relocate_fp) % size);
-            insert_util(relocate_fp, target_hash, id, count + 1);
+        else {
+            i++;
+            continue;
         }
+
+        stash_count--;
+        stash[i] = stash[stash_count];
+        stash_hash[i] = stash_hash[stash_count];
     }
 }
 
 template <typename _Tp, class HF, class FF>
-void CuckooFilterLL<_Tp, HF, FF>::insert(const _Tp key) {
-    uint64_t fp = fingerprint(key);
-    uint32_t _hash = hasher(key) % size;
-    insert_util(fp, _hash, 0, 0);
-    key_count++;
+uint32_t CuckooFilterLL<_Tp, HF, FF>::alt_index(uint64_t fp, uint32_t _hash) const noexcept {
+    return _hash ^ (hasher(fp) & (_CUCKOOFILTER_LL_BLOCK_ROWS - 1));
 }
 
 template <typename _Tp, class HF, class FF>
-bool CuckooFilterLL<_Tp, HF, FF>::lookup(const _Tp key) const noexcept {
+uint8_t CuckooFilterLL<_Tp, HF, FF>::insert_util(uint64_t fp, uint32_t _hash, size_t bucket_id) noexcept {
+    kick_log.clear();
+
+    for (uint32_t count = 0; count < threshold; count++) {
+        uint32_t alt_hash = alt_index(fp, _hash);
+
+        if (not table[2 * _hash]) {
+            table[2 * _hash] = fp;
+            kick_histogram[count]++;
+            return _CUCKOOFILTER_INSERTED;
+        }
+
+        else if (not table[2 * alt_hash + 1]) {
+            table[2 * alt_hash + 1] = fp;
+            kick_histogram[count]++;
+            return _CUCKOOFILTER_INSERTED;
+        }
+
+        size_t id = (count == 0) ? prng() % n_buckets : (bucket_id + 1) % n_buckets;
+
+        uint64_t* target = (id == 0) ? &table[2 * _hash] : &table[2 * alt_hash + 1];
+        kick_log.emplace_back(target, *target);
+
+        uint64_t relocate_fp = *target;
+        *target = fp;
+
+        fp = relocate_fp;
+        _hash = (id == 0) ? _hash : alt_index(fp, alt_hash);
+        bucket_id = id;
+    }
+
+    return stash_or_rollback(fp, _hash);
+}
+
+template <typename _Tp, class HF, class FF>
+uint8_t CuckooFilterLL<_Tp, HF, FF>::insert(const _Tp& key) noexcept {
+    if (read_only) {
+        return _CUCKOOFILTER_READ_ONLY;
+    }
+
     uint64_t fp = fingerprint(key);
+    fp += (fp == 0);
     uint32_t _hash = hasher(key) % size;
 
-    if (table[0][_hash] == fp) {
-        return true;
+    uint8_t status = insert_util(fp, _hash, 0);
+    if (status != _CUCKOOFILTER_FULL) {
+        key_count++;
     }
-    
-    else {
-        _hash = _hash ^ (hasher(fp) % size);
-        if (table[1][_hash] == fp) {
+
+    return status;
+}
+
+template <typename _Tp, class HF, class FF>
+bool CuckooFilterLL<_Tp, HF, FF>::stash_contains(uint64_t fp) const noexcept {
+    for (size_t i = 0; i < stash_count; i++) {
+        if (stash[i] == fp) {
             return true;
         }
     }
@@ -214,20 +464,39 @@ bool CuckooFilterLL<_Tp, HF, FF>::lookup(const _Tp key) const noexcept {
 }
 
 template <typename _Tp, class HF, class FF>
-bool CuckooFilterLL<_Tp, HF, FF>::remove(const _Tp key) noexcept {
-    uint64_t fp = fingerprint(key);
-    uint32_t _hash = hasher(key) % size;
-            
-    if (table[0][_hash] == fp) {
-        table[0][_hash] = 0;
+bool CuckooFilterLL<_Tp, HF, FF>::lookup_util(uint64_t fp, uint32_t _hash, uint32_t alt_hash) const noexcept {
+    if (table[2 * _hash] == fp) {
+        return true;
+    }
+
+    else if (table[2 * alt_hash + 1] == fp) {
+        return true;
+    }
+
+    return stash_contains(fp);
+}
+
+template <typename _Tp, class HF, class FF>
+bool CuckooFilterLL<_Tp, HF, FF>::remove_util(uint64_t fp, uint32_t _hash, uint32_t alt_hash) noexcept {
+    if (table[2 * _hash] == fp) {
+        table[2 * _hash] = 0;
         key_count--;
+        retry_stash();
         return true;
     }
 
-    else {
-        _hash = _hash ^ (hasher(fp) % size);
-        if (table[1][_hash] == fp) {
-            table[1][_hash] = 0;
+    else if (table[2 * alt_hash + 1] == fp) {
+        table[2 * alt_hash + 1] = 0;
+        key_count--;
+        retry_stash();
+        return true;
+    }
+
+    for (size_t i = 0; i < stash_count; i++) {
+        if (stash[i] == fp and stash_hash[i] == _hash) {
+            stash_count--;
+            stash[i] = stash[stash_count];
+            stash_hash[i] = stash_hash[stash_count];
             key_count--;
             return true;
         }
@@ -236,9 +505,103 @@ bool CuckooFilterLL<_Tp, HF, FF>::remove(const _Tp key) noexcept {
     return false;
 }
 
+template <typename _Tp, class HF, class FF>
+void CuckooFilterLL<_Tp, HF, FF>::prepare_batch(const _Tp* keys, const size_t count, uint64_t* fps, uint32_t* hashes, uint32_t* alt_hashes) const noexcept {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t fp = fingerprint(keys[i]);
+        fp += (fp == 0);
+
+        fps[i] = fp;
+        hashes[i] = hasher(keys[i]) % size;
+        alt_hashes[i] = alt_index(fp, hashes[i]);
+
+        BucketProbe::prefetch(table + 2 * hashes[i]);
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+bool CuckooFilterLL<_Tp, HF, FF>::lookup(const _Tp& key) const noexcept {
+    uint64_t fp = fingerprint(key);
+    fp += (fp == 0);
+    uint32_t _hash = hasher(key) % size;
+
+    return lookup_util(fp, _hash, alt_index(fp, _hash));
+}
+
+template <typename _Tp, class HF, class FF>
+void CuckooFilterLL<_Tp, HF, FF>::lookup_batch(const _Tp* keys, const size_t n_keys, bool* results) const noexcept {
+    uint64_t fps[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t alt_hashes[_CUCKOOFILTER_BATCH_SIZE];
+
+    for (size_t base = 0; base < n_keys; base += _CUCKOOFILTER_BATCH_SIZE) {
+        const size_t count = std::min<size_t>(_CUCKOOFILTER_BATCH_SIZE, n_keys - base);
+        prepare_batch(keys + base, count, fps, hashes, alt_hashes);
+
+        for (size_t i = 0; i < count; i++) {
+            results[base + i] = lookup_util(fps[i], hashes[i], alt_hashes[i]);
+        }
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t CuckooFilterLL<_Tp, HF, FF>::contains_count(const _Tp* keys, const size_t n_keys) const noexcept {
+    uint64_t fps[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t alt_hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint64_t count_found = 0;
+
+    for (size_t base = 0; base < n_keys; base += _CUCKOOFILTER_BATCH_SIZE) {
+        const size_t count = std::min<size_t>(_CUCKOOFILTER_BATCH_SIZE, n_keys - base);
+        prepare_batch(keys + base, count, fps, hashes, alt_hashes);
+
+        for (size_t i = 0; i < count; i++) {
+            count_found += lookup_util(fps[i], hashes[i], alt_hashes[i]);
+        }
+    }
+
+    return count_found;
+}
+
+template <typename _Tp, class HF, class FF>
+bool CuckooFilterLL<_Tp, HF, FF>::remove(const _Tp& key) noexcept {
+    if (read_only) {
+        return false;
+    }
+
+    uint64_t fp = fingerprint(key);
+    fp += (fp == 0);
+    uint32_t _hash = hasher(key) % size;
+
+    return remove_util(fp, _hash, alt_index(fp, _hash));
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t CuckooFilterLL<_Tp, HF, FF>::remove_batch(const _Tp* keys, const size_t n_keys) noexcept {
+    if (read_only) {
+        return 0;
+    }
+
+    uint64_t fps[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t alt_hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint64_t count_removed = 0;
+
+    for (size_t base = 0; base < n_keys; base += _CUCKOOFILTER_BATCH_SIZE) {
+        const size_t count = std::min<size_t>(_CUCKOOFILTER_BATCH_SIZE, n_keys - base);
+        prepare_batch(keys + base, count, fps, hashes, alt_hashes);
+
+        for (size_t i = 0; i < count; i++) {
+            count_removed += remove_util(fps[i], hashes[i], alt_hashes[i]);
+        }
+    }
+
+    return count_removed;
+}
+
 template <typename _Tp, class HF, class FF>
 constexpr double CuckooFilterLL<_Tp, HF, FF>::load_factor(void) const noexcept {
-    return double(key_count) / size;
+    return double(key_count) / (size * n_buckets);
 }
 
 template <typename _Tp, class HF, class FF>
@@ -246,187 +609,418 @@ constexpr uint64_t CuckooFilterLL<_Tp, HF, FF>::num_keys(void) const noexcept {
     return key_count;
 }
 
+template <typename _Tp, class HF, class FF>
+constexpr uint64_t CuckooFilterLL<_Tp, HF, FF>::num_stashed(void) const noexcept {
+    return stash_count;
+}
+
+template <typename _Tp, class HF, class FF>
+constexpr uint64_t CuckooFilterLL<_Tp, HF, FF>::num_failures(void) const noexcept {
+    return failed_count;
+}
+
+template <typename _Tp, class HF, class FF>
+constexpr bool CuckooFilterLL<_Tp, HF, FF>::is_read_only(void) const noexcept {
+    return read_only;
+}
+
+template <typename _Tp, class HF, class FF>
+CuckooFilterStats CuckooFilterLL<_Tp, HF, FF>::stats(void) const {
+    CuckooFilterStats stats;
+    stats.kick_chains = kick_histogram;
+    stats.bucket_occupancy.assign(n_buckets + 1, 0);
+    stats.stashed = stashed_total;
+    stats.failed = failed_count;
+    stats.load_at_first_failure = first_failure_load;
+
+    for (uint64_t j = 0; j < size; j++) {
+        size_t occupied = 0;
+        for (size_t i = 0; i < n_buckets; i++) {
+            occupied += (table[j * n_buckets + i] != 0);
+        }
+
+        stats.bucket_occupancy[occupied]++;
+    }
+
+    return stats;
+}
+
 template <typename _Tp, class HF, class FF>
 constexpr uint64_t CuckooFilterLL<_Tp, HF, FF>::size_in_bytes(void) const noexcept {
     return n_buckets * size * sizeof(uint64_t);
 }
 
 template <typename _Tp, class HF, class FF>
-CuckooFilterHL<_Tp, HF, FF>::CuckooFilterHL(const uint64_t size, const uint32_t relocation_threshold, const size_t buckets)
-    : size(size + 7), threshold(relocation_threshold),
-    n_buckets(buckets), key_count(0), hasher(), fingerprint() {
+CuckooFilterHL<_Tp, HF, FF>::CuckooFilterHL(const uint64_t size, const uint32_t relocation_threshold, const size_t buckets, const uint8_t pages)
+    : size(round_pow2(size)), mask(round_pow2(size) - 1), threshold(relocation_threshold), n_buckets(buckets),
+    key_count(0), pages(pages), stash_count(0), failed_count(0), read_only(false),
+    kick_histogram(relocation_threshold), stashed_total(0), first_failure_load(0), hasher(), fingerprint() {
+    table = (uint64_t*) TableMemory::allocate(size_in_bytes(), this->pages);
+    kick_log.reserve(threshold);
+}
+
+template <typename _Tp, class HF, class FF>
+CuckooFilterHL<_Tp, HF, FF>::CuckooFilterHL(const std::string& path, const uint8_t mode)
+    : CuckooFilterHL(CuckooFile::read_header(path, _CUCKOOFILE_KIND_HL, HF::family_id, FF::family_id), path, mode) {}
 
-    table = new uint64_t*[n_buckets];
-    for (size_t i = 0; i < n_buckets; i++) {
-        table[i] = new uint64_t[this->size];
+template <typename _Tp, class HF, class FF>
+CuckooFilterHL<_Tp, HF, FF>::CuckooFilterHL(const CuckooFileHeader& header, const std::string& path, const uint8_t mode)
+    : size(header.size), mask(header.size - 1), threshold(header.threshold), n_buckets(header.n_buckets), key_count(header.key_count),
+    table(nullptr), pages(_TABLEMEMORY_DEFAULT_PAGES),
+    stash_count(header.stash_count), failed_count(header.failed_count), read_only(mode == _CUCKOOFILTER_OPEN_READ_ONLY),
+    kick_histogram(header.threshold), stashed_total(header.stash_count), first_failure_load(0), hasher(), fingerprint() {
+
+    for (size_t i = 0; i < stash_count; i++) {
+        stash[i] = header.stash[i];
+        stash_hash[i] = header.stash_hash[i];
     }
+
+    table = (uint64_t*) TableMemory::map(path, header.table_offset, size_in_bytes(), mode == _CUCKOOFILTER_OPEN_COPY_ON_WRITE, pages);
+    kick_log.reserve(threshold);
 }
 
 template <typename _Tp, class HF, class FF>
-CuckooFilterHL<_Tp, HF, FF>::~CuckooFilterHL(void) {
-    for (size_t i = 0; i < n_buckets; i++) {
-        delete[] table[i];
+void CuckooFilterHL<_Tp, HF, FF>::save(const std::string& path) const {
+    CuckooFileHeader header = CuckooFile::header(_CUCKOOFILE_KIND_HL, HF::family_id, FF::family_id);
+    header.size = size;
+    header.n_buckets = n_buckets;
+    header.threshold = threshold;
+    header.key_count = key_count;
+    header.failed_count = failed_count;
+    header.stash_count = stash_count;
+    header.table_bytes = size_in_bytes();
+
+    for (size_t i = 0; i < stash_count; i++) {
+        header.stash[i] = stash[i];
+        header.stash_hash[i] = stash_hash[i];
     }
-    delete[] table;
+
+    CuckooFile::save(path, header, table);
+}
+
+template <typename _Tp, class HF, class FF>
+CuckooFilterHL<_Tp, HF, FF>::~CuckooFilterHL(void) {
+    TableMemory::release(table, size_in_bytes(), pages);
 }
 
 template <typename _Tp, class HF, class FF>
 CuckooFilterHL<_Tp, HF, FF>::CuckooFilterHL(const CuckooFilterHL& cf_hl)
-    : size(cf_hl.size), threshold(cf_hl.threshold),
-    n_buckets(cf_hl.n_buckets), key_count(cf_hl.key_count), hasher(), fingerprint() {
+    : size(cf_hl.size), mask(cf_hl.mask), threshold(cf_hl.threshold),
+    n_buckets(cf_hl.n_buckets), key_count(cf_hl.key_count), pages(cf_hl.pages), stash_count(cf_hl.stash_count),
+    failed_count(cf_hl.failed_count), read_only(false),
+    kick_histogram(cf_hl.kick_histogram), stashed_total(cf_hl.stashed_total), first_failure_load(cf_hl.first_failure_load), hasher(), fingerprint() {
     
-    table = new uint64_t*[n_buckets];
-    for (size_t i = 0; i < n_buckets; i++) {
-        table[i] = new uint64_t[size];
-
-        for (size_t j = 0; j < size; j++) {
-            table[i][j] = cf_hl.table[i][j];
-        }
+    for (size_t i = 0; i < stash_count; i++) {
+        stash[i] = cf_hl.stash[i];
+        stash_hash[i] = cf_hl.stash_hash[i];
     }
+
+    table = (uint64_t*) TableMemory::allocate(size_in_bytes(), pages);
+    std::memcpy(table, cf_hl.table, size_in_bytes());
+    kick_log.reserve(threshold);
 }
 
 template <typename _Tp, class HF, class FF>
 CuckooFilterHL<_Tp, HF, FF>& CuckooFilterHL<_Tp, HF, FF>::operator=(const CuckooFilterHL& cf_hl) {
-    for (size_t i = 0; i < n_buckets; i++) {
-        delete[] table[i];
-    }
-    delete[] table;
+    TableMemory::release(table, size_in_bytes(), pages);
 
     size = cf_hl.size;
+    mask = cf_hl.mask;
     threshold = cf_hl.threshold;
     n_buckets = cf_hl.n_buckets;
     key_count = cf_hl.key_count;
+    stash_count = cf_hl.stash_count;
+    failed_count = cf_hl.failed_count;
+    read_only = false;
+    kick_histogram = cf_hl.kick_histogram;
+    stashed_total = cf_hl.stashed_total;
+    first_failure_load = cf_hl.first_failure_load;
+    pages = cf_hl.pages;
     hasher = cf_hl.hasher;
     fingerprint = cf_hl.fingerprint;
 
-    table = new uint64_t*[n_buckets];
-    for (size_t i = 0; i < n_buckets; i++) {
-        table[i] = new uint64_t[size];
-
-        for (size_t j = 0; j < size; j++) {
-            table[i][j] = cf_hl.table[i][j];
-        }
+    for (size_t i = 0; i < stash_count; i++) {
+        stash[i] = cf_hl.stash[i];
+        stash_hash[i] = cf_hl.stash_hash[i];
     }
 
+    table = (uint64_t*) TableMemory::allocate(size_in_bytes(), pages);
+    std::memcpy(table, cf_hl.table, size_in_bytes());
+
     return *this;
 }
 
 template <typename _Tp, class HF, class FF>
-void CuckooFilterHL<_Tp, HF, FF>::insert_util(uint64_t fp, uint32_t _hash, size_t bucket_id, size_t count) {
-    if (count == threshold) {
-        std::string exc_msg = "relocation threshold reached: " + std::to_string(threshold);
-        throw std::overflow_error(exc_msg.c_str());
+uint8_t CuckooFilterHL<_Tp, HF, FF>::stash_or_rollback(uint64_t fp, uint32_t _hash) noexcept {
+    if (stash_count < _CUCKOOFILTER_STASH_SIZE) {
+        stash[stash_count] = fp;
+        stash_hash[stash_count++] = _hash;
+        stashed_total++;
+        return _CUCKOOFILTER_STASHED;
+    }
+
+    while (not kick_log.empty()) {
+        *kick_log.back().first = kick_log.back().second;
+        kick_log.pop_back();
     }
 
-    else if (not table[bucket_id][_hash]) {
-        table[bucket_id][_hash] = fp;
+    if (not failed_count) {
+        first_failure_load = load_factor();
     }
 
-    else {
-        size_t id = (bucket_id + 1) % n_buckets;
-        uint32_t alt_hash = (_hash ^ hasher(fp)) % size;
+    failed_count++;
+    return _CUCKOOFILTER_FULL;
+}
 
-        if (not table[id][alt_hash]) {
-            table[id][alt_hash] = fp;
+template <typename _Tp, class HF, class FF>
+void CuckooFilterHL<_Tp, HF, FF>::retry_stash(void) noexcept {
+    for (size_t i = 0; i < stash_count; ) {
+        uint64_t* slot = nullptr;
+        uint64_t* bucket = table + stash_hash[i] * n_buckets;
+        uint64_t* alt_bucket = table + alt_index(stash[i], stash_hash[i]) * n_buckets;
+
+        for (size_t j = 0; j < n_buckets and slot == nullptr; j++) {
+            if (not bucket[j]) {
+                slot = &bucket[j];
+            }
+
+            else if (not alt_bucket[j]) {
+                slot = &alt_bucket[j];
+            }
         }
 
-        else {
-            id = prng() % n_buckets;
-            uint32_t target_hash = (id == 0) ? _hash : alt_hash;
-            uint32_t relocate_fp = table[id][target_hash];
-
-            table[id][target_hash] = fp;
-            target_hash = (target_hash ^ hasher(relocate_fp)) % size;
-            insert_util(relocate_fp, target_hash, id, count + 1);
+        if (slot == nullptr) {
+            i++;
+            continue;
         }
+
+        *slot = stash[i];
+        stash_count--;
+        stash[i] = stash[stash_count];
+        stash_hash[i] = stash_hash[stash_count];
     }
 }
 
 template <typename _Tp, class HF, class FF>
-bool CuckooFilterHL<_Tp, HF, FF>::lookup_util(uint64_t fp, uint32_t _hash, size_t bucket_id, size_t count) const noexcept {
-    if (count == threshold) {
-        return false;
+uint64_t CuckooFilterHL<_Tp, HF, FF>::round_pow2(uint64_t n) noexcept {
+    uint64_t pow2 = 1;
+    while (pow2 < n) {
+        pow2 <<= 1;
     }
 
-    else if (table[bucket_id][_hash] == fp) {
-        return true;
-    }
+    return pow2;
+}
 
-    else {
-        size_t id = (bucket_id + 1) % n_buckets;
-        uint32_t alt_hash = (_hash ^ hasher(fp)) % size;
+template <typename _Tp, class HF, class FF>
+uint32_t CuckooFilterHL<_Tp, HF, FF>::alt_index(uint64_t fp, uint32_t _hash) const noexcept {
+    return (_hash ^ hasher(fp)) & mask;
+}
 
-        if (table[id][alt_hash] == fp) {
-            return true;
+template <typename _Tp, class HF, class FF>
+uint8_t CuckooFilterHL<_Tp, HF, FF>::insert_util(uint64_t fp, uint32_t _hash, size_t slot) noexcept {
+    kick_log.clear();
+
+    for (uint32_t count = 0; count < threshold; count++) {
+        uint32_t alt_hash = alt_index(fp, _hash);
+        uint64_t* bucket = table + _hash * n_buckets;
+        uint64_t* alt_bucket = table + alt_hash * n_buckets;
+
+        for (size_t i = 0; i < n_buckets; i++) {
+            if (not bucket[i]) {
+                bucket[i] = fp;
+                kick_histogram[count]++;
+                return _CUCKOOFILTER_INSERTED;
+            }
         }
 
-        else {
-            id = (bucket_id + 1) % n_buckets;
-            alt_hash = (alt_hash ^ hasher(fp)) % size;
-            return lookup_util(fp, alt_hash, id, count + 1);
+        for (size_t i = 0; i < n_buckets; i++) {
+            if (not alt_bucket[i]) {
+                alt_bucket[i] = fp;
+                kick_histogram[count]++;
+                return _CUCKOOFILTER_INSERTED;
+            }
         }
+
+        uint32_t target_hash = (count > 0 or prng() % 2) ? _hash : alt_hash;
+        uint64_t* target = table + target_hash * n_buckets;
+        slot = (slot + 1 + prng() % n_buckets) % n_buckets;
+        kick_log.emplace_back(&target[slot], target[slot]);
+
+        uint64_t relocate_fp = target[slot];
+        target[slot] = fp;
+
+        fp = relocate_fp;
+        _hash = alt_index(fp, target_hash);
     }
+
+    return stash_or_rollback(fp, _hash);
 }
 
 template <typename _Tp, class HF, class FF>
-bool CuckooFilterHL<_Tp, HF, FF>::remove_util(uint64_t fp, uint32_t _hash, size_t bucket_id, size_t count) noexcept {
-    if (count == threshold) {
-        return false;
+uint8_t CuckooFilterHL<_Tp, HF, FF>::insert(const _Tp& key) noexcept {
+    if (read_only) {
+        return _CUCKOOFILTER_READ_ONLY;
     }
 
-    else if (table[bucket_id][_hash] == fp) {
-        table[bucket_id][_hash] = 0;
-        return true;
+    uint64_t fp = fingerprint(key);
+    fp += (fp == 0);
+    uint32_t _hash = hasher(key) & mask;
+
+    uint8_t status = insert_util(fp, _hash, 0);
+    if (status != _CUCKOOFILTER_FULL) {
+        key_count++;
     }
 
-    else {
-        size_t id = (bucket_id + 1) % n_buckets;
-        uint32_t alt_hash = (_hash ^ hasher(fp)) % size;
+    return status;
+}
 
-        if (table[id][alt_hash] == fp) {
-            table[id][alt_hash] = 0;
+template <typename _Tp, class HF, class FF>
+bool CuckooFilterHL<_Tp, HF, FF>::stash_contains(uint64_t fp) const noexcept {
+    for (size_t i = 0; i < stash_count; i++) {
+        if (stash[i] == fp) {
             return true;
         }
+    }
 
-        else {
-            id = (bucket_id + 1) % n_buckets;
-            alt_hash = (alt_hash ^ hasher(fp)) % size;
-            return remove_util(fp, alt_hash, id, count + 1);
+    return false;
+}
+
+template <typename _Tp, class HF, class FF>
+bool CuckooFilterHL<_Tp, HF, FF>::lookup_util(uint64_t fp, uint32_t _hash, uint32_t alt_hash) const noexcept {
+    return BucketProbe::contains(table + _hash * n_buckets, table + alt_hash * n_buckets, n_buckets, fp)
+        or stash_contains(fp);
+}
+
+template <typename _Tp, class HF, class FF>
+bool CuckooFilterHL<_Tp, HF, FF>::remove_util(uint64_t fp, uint32_t _hash, uint32_t alt_hash) noexcept {
+    uint64_t* bucket = table + _hash * n_buckets;
+    uint64_t* alt_bucket = table + alt_hash * n_buckets;
+
+    if (uint32_t hits = BucketProbe::match(bucket, n_buckets, fp)) {
+        bucket[BucketProbe::first(hits)] = 0;
+        key_count--;
+        retry_stash();
+        return true;
+    }
+
+    if (uint32_t hits = BucketProbe::match(alt_bucket, n_buckets, fp)) {
+        alt_bucket[BucketProbe::first(hits)] = 0;
+        key_count--;
+        retry_stash();
+        return true;
+    }
+
+    for (size_t i = 0; i < stash_count; i++) {
+        if (stash[i] == fp and (stash_hash[i] == _hash or stash_hash[i] == alt_hash)) {
+            stash_count--;
+            stash[i] = stash[stash_count];
+            stash_hash[i] = stash_hash[stash_count];
+            key_count--;
+            return true;
         }
     }
+
+    return false;
 }
 
 template <typename _Tp, class HF, class FF>
-void CuckooFilterHL<_Tp, HF, FF>::insert(const _Tp key) {
-    uint64_t fp = fingerprint(key);
-    uint32_t _hash = hasher(key) % size;
-    insert_util(fp, _hash, 0, 0);
-    key_count++;
+void CuckooFilterHL<_Tp, HF, FF>::prepare_batch(const _Tp* keys, const size_t count, uint64_t* fps, uint32_t* hashes, uint32_t* alt_hashes) const noexcept {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t fp = fingerprint(keys[i]);
+        fp += (fp == 0);
+
+        fps[i] = fp;
+        hashes[i] = hasher(keys[i]) & mask;
+        alt_hashes[i] = alt_index(fp, hashes[i]);
+
+        BucketProbe::prefetch(table + hashes[i] * n_buckets);
+        BucketProbe::prefetch(table + alt_hashes[i] * n_buckets);
+    }
 }
 
 template <typename _Tp, class HF, class FF>
-bool CuckooFilterHL<_Tp, HF, FF>::lookup(const _Tp key) const noexcept {
+bool CuckooFilterHL<_Tp, HF, FF>::lookup(const _Tp& key) const noexcept {
     uint64_t fp = fingerprint(key);
-    uint32_t _hash = hasher(key) % size;
-    return lookup_util(fp, _hash, 0, 0);
+    fp += (fp == 0);
+    uint32_t _hash = hasher(key) & mask;
+
+    return lookup_util(fp, _hash, alt_index(fp, _hash));
 }
 
 template <typename _Tp, class HF, class FF>
-bool CuckooFilterHL<_Tp, HF, FF>::remove(const _Tp key) noexcept {
+void CuckooFilterHL<_Tp, HF, FF>::lookup_batch(const _Tp* keys, const size_t n_keys, bool* results) const noexcept {
+    uint64_t fps[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t alt_hashes[_CUCKOOFILTER_BATCH_SIZE];
+
+    for (size_t base = 0; base < n_keys; base += _CUCKOOFILTER_BATCH_SIZE) {
+        const size_t count = std::min<size_t>(_CUCKOOFILTER_BATCH_SIZE, n_keys - base);
+        prepare_batch(keys + base, count, fps, hashes, alt_hashes);
+
+        for (size_t i = 0; i < count; i++) {
+            results[base + i] = lookup_util(fps[i], hashes[i], alt_hashes[i]);
+        }
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t CuckooFilterHL<_Tp, HF, FF>::contains_count(const _Tp* keys, const size_t n_keys) const noexcept {
+    uint64_t fps[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t alt_hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint64_t count_found = 0;
+
+    for (size_t base = 0; base < n_keys; base += _CUCKOOFILTER_BATCH_SIZE) {
+        const size_t count = std::min<size_t>(_CUCKOOFILTER_BATCH_SIZE, n_keys - base);
+        prepare_batch(keys + base, count, fps, hashes, alt_hashes);
+
+        for (size_t i = 0; i < count; i++) {
+            count_found += lookup_util(fps[i], hashes[i], alt_hashes[i]);
+        }
+    }
+
+    return count_found;
+}
+
+template <typename _Tp, class HF, class FF>
+bool CuckooFilterHL<_Tp, HF, FF>::remove(const _Tp& key) noexcept {
+    if (read_only) {
+        return false;
+    }
+
     uint64_t fp = fingerprint(key);
-    uint32_t _hash = hasher(key) % size;
+    fp += (fp == 0);
+    uint32_t _hash = hasher(key) & mask;
 
-    if (remove_util(fp, _hash, 0, 0)) {
-        key_count--;
-        return true;
+    return remove_util(fp, _hash, alt_index(fp, _hash));
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t CuckooFilterHL<_Tp, HF, FF>::remove_batch(const _Tp* keys, const size_t n_keys) noexcept {
+    if (read_only) {
+        return 0;
     }
 
-    return false;
+    uint64_t fps[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint32_t alt_hashes[_CUCKOOFILTER_BATCH_SIZE];
+    uint64_t count_removed = 0;
+
+    for (size_t base = 0; base < n_keys; base += _CUCKOOFILTER_BATCH_SIZE) {
+        const size_t count = std::min<size_t>(_CUCKOOFILTER_BATCH_SIZE, n_keys - base);
+        prepare_batch(keys + base, count, fps, hashes, alt_hashes);
+
+        for (size_t i = 0; i < count; i++) {
+            count_removed += remove_util(fps[i], hashes[i], alt_hashes[i]);
+        }
+    }
+
+    return count_removed;
 }
 
 template <typename _Tp, class HF, class FF>
 constexpr double CuckooFilterHL<_Tp, HF, FF>::load_factor(void) const noexcept {
-    return double(key_count) / size;
+    return double(key_count) / (size * n_buckets);
 }
 
 template <typename _Tp, class HF, class FF>
@@ -434,6 +1028,42 @@ constexpr uint64_t CuckooFilterHL<_Tp, HF, FF>::num_keys(void) const noexcept {
     return key_count;
 }
 
+template <typename _Tp, class HF, class FF>
+constexpr uint64_t CuckooFilterHL<_Tp, HF, FF>::num_stashed(void) const noexcept {
+    return stash_count;
+}
+
+template <typename _Tp, class HF, class FF>
+constexpr uint64_t CuckooFilterHL<_Tp, HF, FF>::num_failures(void) const noexcept {
+    return failed_count;
+}
+
+template <typename _Tp, class HF, class FF>
+constexpr bool CuckooFilterHL<_Tp, HF, FF>::is_read_only(void) const noexcept {
+    return read_only;
+}
+
+template <typename _Tp, class HF, class FF>
+CuckooFilterStats CuckooFilterHL<_Tp, HF, FF>::stats(void) const {
+    CuckooFilterStats stats;
+    stats.kick_chains = kick_histogram;
+    stats.bucket_occupancy.assign(n_buckets + 1, 0);
+    stats.stashed = stashed_total;
+    stats.failed = failed_count;
+    stats.load_at_first_failure = first_failure_load;
+
+    for (uint64_t j = 0; j < size; j++) {
+        size_t occupied = 0;
+        for (size_t i = 0; i < n_buckets; i++) {
+            occupied += (table[j * n_buckets + i] != 0);
+        }
+
+        stats.bucket_occupancy[occupied]++;
+    }
+
+    return stats;
+}
+
 template <typename _Tp, class HF, class FF>
 constexpr uint64_t CuckooFilterHL<_Tp, HF, FF>::size_in_bytes(void) const noexcept {
     return n_buckets * size * sizeof(uint64_t);
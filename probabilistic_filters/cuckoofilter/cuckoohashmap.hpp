@@ -0,0 +1,282 @@
+#pragma once
+
+#include <random>
+#include <utility>
+#include "tablememory.hpp"
+#include "bucketprobe.hpp"
+
+#ifndef _CUCKOOHASHMAP_SLOTS
+    #define _CUCKOOHASHMAP_SLOTS 8
+#endif
+
+#ifndef _CUCKOOHASHMAP_MAX_LOAD
+    #define _CUCKOOHASHMAP_MAX_LOAD 0.95
+#endif
+
+template <typename _Key, typename _Val, class HashFamily>
+class CuckooHashMap {
+    private:
+        uint64_t size;
+        uint64_t mask;
+        const uint32_t threshold;
+        uint64_t key_count;
+        uint64_t rehash_count;
+
+        uint8_t* tags;
+        _Key* keys;
+        _Val* values;
+        uint8_t pages;
+
+        std::minstd_rand prng;
+
+        const HashFamily hasher;
+
+        static uint64_t round_pow2(uint64_t) noexcept;
+
+        static uint8_t tag_of(uint32_t) noexcept;
+
+        uint32_t alt_index(uint8_t, uint32_t) const noexcept;
+
+        void allocate(void);
+
+        void release(void) noexcept;
+
+        uint64_t locate(const _Key&) const noexcept;
+
+        bool try_place(uint8_t, uint32_t, _Key&, _Val&) noexcept;
+
+        void insert_util(uint8_t, uint32_t, _Key, _Val);
+
+        void rehash(void);
+
+    public:
+        explicit CuckooHashMap(const uint64_t = 16, const uint32_t = 500);
+
+        CuckooHashMap(const CuckooHashMap&) = delete;
+
+        CuckooHashMap& operator=(const CuckooHashMap&) = delete;
+
+        ~CuckooHashMap(void);
+
+        _Val* find(const _Key&) noexcept;
+
+        const _Val* find(const _Key&) const noexcept;
+
+        bool contains(const _Key&) const noexcept;
+
+        bool insert_or_assign(const _Key&, const _Val&);
+
+        bool erase(const _Key&) noexcept;
+
+        double load_factor(void) const noexcept;
+
+        uint64_t num_keys(void) const noexcept;
+
+        uint64_t num_rehashes(void) const noexcept;
+
+        uint64_t size_in_bytes(void) const noexcept;
+};
+
+template <typename _Key, typename _Val, class HF>
+CuckooHashMap<_Key, _Val, HF>::CuckooHashMap(const uint64_t capacity, const uint32_t relocation_threshold)
+    : size(round_pow2((capacity + _CUCKOOHASHMAP_SLOTS - 1) / _CUCKOOHASHMAP_SLOTS)), threshold(relocation_threshold),
+    key_count(0), rehash_count(0), prng(), hasher() {
+    mask = size - 1;
+    allocate();
+}
+
+template <typename _Key, typename _Val, class HF>
+CuckooHashMap<_Key, _Val, HF>::~CuckooHashMap(void) {
+    release();
+}
+
+template <typename _Key, typename _Val, class HF>
+uint64_t CuckooHashMap<_Key, _Val, HF>::round_pow2(uint64_t n) noexcept {
+    uint64_t pow2 = 1;
+    while (pow2 < n) {
+        pow2 <<= 1;
+    }
+
+    return pow2;
+}
+
+template <typename _Key, typename _Val, class HF>
+uint8_t CuckooHashMap<_Key, _Val, HF>::tag_of(uint32_t _hash) noexcept {
+    uint8_t tag = _hash >> 24;
+    return tag + (tag == 0);
+}
+
+template <typename _Key, typename _Val, class HF>
+uint32_t CuckooHashMap<_Key, _Val, HF>::alt_index(uint8_t tag, uint32_t _hash) const noexcept {
+    return (_hash ^ (tag * 0x5bd1e995U)) & mask;
+}
+
+template <typename _Key, typename _Val, class HF>
+void CuckooHashMap<_Key, _Val, HF>::allocate(void) {
+    pages = _TABLEMEMORY_DEFAULT_PAGES;
+    tags = (uint8_t*) TableMemory::allocate(size * _CUCKOOHASHMAP_SLOTS, pages);
+    keys = new _Key[size * _CUCKOOHASHMAP_SLOTS];
+    values = new _Val[size * _CUCKOOHASHMAP_SLOTS];
+}
+
+template <typename _Key, typename _Val, class HF>
+void CuckooHashMap<_Key, _Val, HF>::release(void) noexcept {
+    TableMemory::release(tags, size * _CUCKOOHASHMAP_SLOTS, pages);
+    delete[] keys;
+    delete[] values;
+}
+
+template <typename _Key, typename _Val, class HF>
+uint64_t CuckooHashMap<_Key, _Val, HF>::locate(const _Key& key) const noexcept {
+    uint32_t _hash = hasher(key);
+    uint8_t tag = tag_of(_hash);
+    const uint32_t buckets[2] = {uint32_t(_hash & mask), alt_index(tag, _hash & mask)};
+
+    BucketProbe::prefetch((const uint64_t*) (tags + buckets[1] * _CUCKOOHASHMAP_SLOTS));
+
+    for (uint32_t bucket : buckets) {
+        const uint64_t base = uint64_t(bucket) * _CUCKOOHASHMAP_SLOTS;
+
+        for (uint32_t hits = BucketProbe::match_tags(tags + base, _CUCKOOHASHMAP_SLOTS, tag); hits; hits &= hits - 1) {
+            const uint64_t pos = base + BucketProbe::first(hits);
+            if (keys[pos] == key) {
+                return pos;
+            }
+        }
+    }
+
+    return size * _CUCKOOHASHMAP_SLOTS;
+}
+
+template <typename _Key, typename _Val, class HF>
+bool CuckooHashMap<_Key, _Val, HF>::try_place(uint8_t tag, uint32_t bucket, _Key& key, _Val& value) noexcept {
+    const uint64_t base = uint64_t(bucket) * _CUCKOOHASHMAP_SLOTS;
+    uint32_t empty = BucketProbe::match_tags(tags + base, _CUCKOOHASHMAP_SLOTS, 0);
+
+    if (not empty) {
+        return false;
+    }
+
+    const uint64_t pos = base + BucketProbe::first(empty);
+    tags[pos] = tag;
+    keys[pos] = std::move(key);
+    values[pos] = std::move(value);
+    return true;
+}
+
+template <typename _Key, typename _Val, class HF>
+void CuckooHashMap<_Key, _Val, HF>::insert_util(uint8_t tag, uint32_t _hash, _Key key, _Val value) {
+    for (uint32_t count = 0; count < threshold; count++) {
+        uint32_t alt_hash = alt_index(tag, _hash);
+
+        if (try_place(tag, _hash, key, value) or try_place(tag, alt_hash, key, value)) {
+            key_count++;
+            return;
+        }
+
+        uint32_t target_hash = (count > 0 or prng() % 2) ? _hash : alt_hash;
+        const uint64_t pos = uint64_t(target_hash) * _CUCKOOHASHMAP_SLOTS + prng() % _CUCKOOHASHMAP_SLOTS;
+
+        std::swap(tag, tags[pos]);
+        std::swap(key, keys[pos]);
+        std::swap(value, values[pos]);
+        _hash = alt_index(tag, target_hash);
+    }
+
+    rehash();
+    _hash = hasher(key) & mask;
+    insert_util(tag, _hash, std::move(key), std::move(value));
+}
+
+template <typename _Key, typename _Val, class HF>
+void CuckooHashMap<_Key, _Val, HF>::rehash(void) {
+    uint8_t* old_tags = tags;
+    _Key* old_keys = keys;
+    _Val* old_values = values;
+    const uint64_t old_slots = size * _CUCKOOHASHMAP_SLOTS;
+    const uint8_t old_pages = pages;
+
+    size *= 2;
+    mask = size - 1;
+    key_count = 0;
+    rehash_count++;
+    allocate();
+
+    for (uint64_t pos = 0; pos < old_slots; pos++) {
+        if (old_tags[pos]) {
+            uint32_t _hash = hasher(old_keys[pos]) & mask;
+            insert_util(old_tags[pos], _hash, std::move(old_keys[pos]), std::move(old_values[pos]));
+        }
+    }
+
+    TableMemory::release(old_tags, old_slots, old_pages);
+    delete[] old_keys;
+    delete[] old_values;
+}
+
+template <typename _Key, typename _Val, class HF>
+_Val* CuckooHashMap<_Key, _Val, HF>::find(const _Key& key) noexcept {
+    uint64_t pos = locate(key);
+    return pos < size * _CUCKOOHASHMAP_SLOTS ? values + pos : nullptr;
+}
+
+template <typename _Key, typename _Val, class HF>
+const _Val* CuckooHashMap<_Key, _Val, HF>::find(const _Key& key) const noexcept {
+    uint64_t pos = locate(key);
+    return pos < size * _CUCKOOHASHMAP_SLOTS ? values + pos : nullptr;
+}
+
+template <typename _Key, typename _Val, class HF>
+bool CuckooHashMap<_Key, _Val, HF>::contains(const _Key& key) const noexcept {
+    return locate(key) < size * _CUCKOOHASHMAP_SLOTS;
+}
+
+template <typename _Key, typename _Val, class HF>
+bool CuckooHashMap<_Key, _Val, HF>::insert_or_assign(const _Key& key, const _Val& value) {
+    if (_Val* found = find(key)) {
+        *found = value;
+        return false;
+    }
+
+    if (key_count + 1 > _CUCKOOHASHMAP_MAX_LOAD * size * _CUCKOOHASHMAP_SLOTS) {
+        rehash();
+    }
+
+    uint32_t _hash = hasher(key);
+    insert_util(tag_of(_hash), _hash & mask, key, value);
+    return true;
+}
+
+template <typename _Key, typename _Val, class HF>
+bool CuckooHashMap<_Key, _Val, HF>::erase(const _Key& key) noexcept {
+    uint64_t pos = locate(key);
+    if (pos == size * _CUCKOOHASHMAP_SLOTS) {
+        return false;
+    }
+
+    tags[pos] = 0;
+    keys[pos] = _Key();
+    values[pos] = _Val();
+    key_count--;
+    return true;
+}
+
+template <typename _Key, typename _Val, class HF>
+double CuckooHashMap<_Key, _Val, HF>::load_factor(void) const noexcept {
+    return double(key_count) / (size * _CUCKOOHASHMAP_SLOTS);
+}
+
+template <typename _Key, typename _Val, class HF>
+uint64_t CuckooHashMap<_Key, _Val, HF>::num_keys(void) const noexcept {
+    return key_count;
+}
+
+template <typename _Key, typename _Val, class HF>
+uint64_t CuckooHashMap<_Key, _Val, HF>::num_rehashes(void) const noexcept {
+    return rehash_count;
+}
+
+template <typename _Key, typename _Val, class HF>
+uint64_t CuckooHashMap<_Key, _Val, HF>::size_in_bytes(void) const noexcept {
+    return size * _CUCKOOHASHMAP_SLOTS * (sizeof(uint8_t) + sizeof(_Key) + sizeof(_Val));
+}
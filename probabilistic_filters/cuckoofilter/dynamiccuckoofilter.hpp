@@ -0,0 +1,191 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include "cuckoofilter.hpp"
+
+template <typename _Tp, class HashFamily, class FingerprintFamily>
+class DynamicCuckooFilter {
+    private:
+        typedef CuckooFilterHL<_Tp, HashFamily, FingerprintFamily> SubFilter;
+
+        const uint64_t initial_size;
+        const uint32_t threshold;
+        const size_t n_buckets;
+        uint64_t compact_below;
+
+        std::vector<SubFilter*> filters;
+
+        void grow(void);
+
+        bool drain(SubFilter*, const size_t) noexcept;
+
+    public:
+        explicit DynamicCuckooFilter(const uint64_t, const uint32_t, const size_t = 4);
+
+        DynamicCuckooFilter(const DynamicCuckooFilter&) = delete;
+
+        DynamicCuckooFilter& operator=(const DynamicCuckooFilter&) = delete;
+
+        ~DynamicCuckooFilter(void);
+
+        uint8_t insert(const _Tp&);
+
+        bool lookup(const _Tp&) const noexcept;
+
+        bool remove(const _Tp&) noexcept;
+
+        void compact(void) noexcept;
+
+        double load_factor(void) const noexcept;
+
+        uint64_t num_keys(void) const noexcept;
+
+        size_t num_filters(void) const noexcept;
+
+        uint64_t size_in_bytes(void) const noexcept;
+};
+
+template <typename _Tp, class HF, class FF>
+DynamicCuckooFilter<_Tp, HF, FF>::DynamicCuckooFilter(const uint64_t size, const uint32_t relocation_threshold, const size_t buckets)
+    : initial_size(size), threshold(relocation_threshold), n_buckets(buckets),
+    compact_below(std::numeric_limits<uint64_t>::max()) {
+    grow();
+}
+
+template <typename _Tp, class HF, class FF>
+DynamicCuckooFilter<_Tp, HF, FF>::~DynamicCuckooFilter(void) {
+    for (SubFilter* filter : filters) {
+        delete filter;
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+void DynamicCuckooFilter<_Tp, HF, FF>::grow(void) {
+    uint64_t size = filters.empty() ? initial_size : 2 * filters.back()->size;
+    filters.push_back(new SubFilter(size, threshold, n_buckets));
+    compact_below = std::numeric_limits<uint64_t>::max();
+}
+
+template <typename _Tp, class HF, class FF>
+bool DynamicCuckooFilter<_Tp, HF, FF>::drain(SubFilter* source, const size_t n_targets) noexcept {
+    if (source->stash_count) {
+        return false;
+    }
+
+    for (uint64_t j = 0; j < source->size; j++) {
+        for (size_t i = 0; i < source->n_buckets; i++) {
+            uint64_t fp = source->table[j * source->n_buckets + i];
+            if (not fp) {
+                continue;
+            }
+
+            bool moved = false;
+            for (size_t k = 0; k < n_targets and not moved; k++) {
+                SubFilter* target = filters[k];
+                if (target->insert_util(fp, j & target->mask, 0) != _CUCKOOFILTER_FULL) {
+                    target->key_count++;
+                    moved = true;
+                }
+            }
+
+            if (not moved) {
+                return false;
+            }
+
+            source->table[j * source->n_buckets + i] = 0;
+            source->key_count--;
+        }
+    }
+
+    return true;
+}
+
+template <typename _Tp, class HF, class FF>
+uint8_t DynamicCuckooFilter<_Tp, HF, FF>::insert(const _Tp& key) {
+    uint8_t status = filters.back()->insert(key);
+
+    if (status == _CUCKOOFILTER_FULL) {
+        grow();
+        status = filters.back()->insert(key);
+    }
+
+    return status;
+}
+
+template <typename _Tp, class HF, class FF>
+bool DynamicCuckooFilter<_Tp, HF, FF>::lookup(const _Tp& key) const noexcept {
+    for (size_t k = filters.size(); k > 0; k--) {
+        if (filters[k - 1]->lookup(key)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename _Tp, class HF, class FF>
+bool DynamicCuckooFilter<_Tp, HF, FF>::remove(const _Tp& key) noexcept {
+    for (size_t k = filters.size(); k > 0; k--) {
+        if (filters[k - 1]->remove(key)) {
+            uint64_t count = num_keys();
+            if (filters.size() > 1 and count < compact_below and 4 * count < filters.back()->size * n_buckets) {
+                compact();
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename _Tp, class HF, class FF>
+void DynamicCuckooFilter<_Tp, HF, FF>::compact(void) noexcept {
+    while (filters.size() > 1) {
+        SubFilter* newest = filters.back();
+
+        if (not drain(newest, filters.size() - 1)) {
+            compact_below = num_keys() / 2;
+            break;
+        }
+
+        delete newest;
+        filters.pop_back();
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+double DynamicCuckooFilter<_Tp, HF, FF>::load_factor(void) const noexcept {
+    uint64_t slots = 0;
+    for (const SubFilter* filter : filters) {
+        slots += filter->size * filter->n_buckets;
+    }
+
+    return double(num_keys()) / slots;
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t DynamicCuckooFilter<_Tp, HF, FF>::num_keys(void) const noexcept {
+    uint64_t count = 0;
+    for (const SubFilter* filter : filters) {
+        count += filter->num_keys();
+    }
+
+    return count;
+}
+
+template <typename _Tp, class HF, class FF>
+size_t DynamicCuckooFilter<_Tp, HF, FF>::num_filters(void) const noexcept {
+    return filters.size();
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t DynamicCuckooFilter<_Tp, HF, FF>::size_in_bytes(void) const noexcept {
+    uint64_t bytes = 0;
+    for (const SubFilter* filter : filters) {
+        bytes += filter->size_in_bytes();
+    }
+
+    return bytes;
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <random>
+#include <vector>
+#include <utility>
+#include <cstring>
+#include "tablememory.hpp"
+
+#ifndef _CUCKOOFILTER_INSERTED
+    #define _CUCKOOFILTER_INSERTED 0
+#endif
+
+#ifndef _CUCKOOFILTER_FULL
+    #define _CUCKOOFILTER_FULL 2
+#endif
+
+#ifndef _MORTONBLOCK_SLOTS
+    #define _MORTONBLOCK_SLOTS 46
+#endif
+
+#ifndef _MORTONBLOCK_BUCKETS
+    #define _MORTONBLOCK_BUCKETS 64
+#endif
+
+#ifndef _MORTONBLOCK_BUCKET_CAPACITY
+    #define _MORTONBLOCK_BUCKET_CAPACITY 3
+#endif
+
+#ifndef _MORTONBLOCK_OVERFLOW_BITS
+    #define _MORTONBLOCK_OVERFLOW_BITS 16
+#endif
+
+struct alignas(_TABLEMEMORY_CACHE_LINE) MortonBlock {
+    uint64_t fca[2];
+    uint16_t ota;
+    uint8_t fsa[_MORTONBLOCK_SLOTS];
+};
+
+template <typename _Tp, class HashFamily, class FingerprintFamily>
+class MortonCuckooFilter {
+    private:
+        const uint64_t n_blocks;
+        const uint64_t mask;
+        const uint32_t threshold;
+        uint64_t key_count;
+        uint64_t failed_count;
+
+        MortonBlock* blocks;
+        uint8_t pages;
+
+        std::vector<std::pair<uint64_t, uint8_t>> kick_log;
+
+        std::random_device prng;
+
+        const HashFamily hasher;
+        const FingerprintFamily fingerprint;
+
+        static uint64_t round_pow2(uint64_t) noexcept;
+
+        static size_t counter(const MortonBlock&, const size_t) noexcept;
+
+        static size_t offset(const MortonBlock&, const size_t) noexcept;
+
+        static size_t occupancy(const MortonBlock&) noexcept;
+
+        uint8_t fingerprint_util(const _Tp&) const noexcept;
+
+        uint64_t alt_index(uint8_t, uint64_t) const noexcept;
+
+        bool can_store(uint64_t) const noexcept;
+
+        void store(uint8_t, uint64_t) noexcept;
+
+        uint8_t evict(uint64_t, const size_t) noexcept;
+
+        bool bucket_contains(uint8_t, uint64_t) const noexcept;
+
+        bool bucket_remove(uint8_t, uint64_t) noexcept;
+
+        bool overflowed(uint64_t) const noexcept;
+
+        void mark_overflow(uint64_t) noexcept;
+
+    public:
+        explicit MortonCuckooFilter(const uint64_t, const uint32_t, const uint8_t = _TABLEMEMORY_DEFAULT_PAGES);
+
+        MortonCuckooFilter(const MortonCuckooFilter&) = delete;
+
+        MortonCuckooFilter& operator=(const MortonCuckooFilter&) = delete;
+
+        ~MortonCuckooFilter(void);
+
+        uint8_t insert(const _Tp&) noexcept;
+
+        bool lookup(const _Tp&) const noexcept;
+
+        bool remove(const _Tp&) noexcept;
+
+        double load_factor(void) const noexcept;
+
+        uint64_t num_keys(void) const noexcept;
+
+        uint64_t num_failures(void) const noexcept;
+
+        uint64_t size_in_bytes(void) const noexcept;
+};
+
+template <typename _Tp, class HF, class FF>
+MortonCuckooFilter<_Tp, HF, FF>::MortonCuckooFilter(const uint64_t size, const uint32_t relocation_threshold, const uint8_t pages)
+    : n_blocks(round_pow2((size + _MORTONBLOCK_SLOTS - 1) / _MORTONBLOCK_SLOTS)),
+    mask(round_pow2((size + _MORTONBLOCK_SLOTS - 1) / _MORTONBLOCK_SLOTS) * _MORTONBLOCK_BUCKETS - 1),
+    threshold(relocation_threshold), key_count(0), failed_count(0), pages(pages), prng(), hasher(), fingerprint() {
+
+    blocks = (MortonBlock*) TableMemory::allocate(size_in_bytes(), this->pages);
+}
+
+template <typename _Tp, class HF, class FF>
+MortonCuckooFilter<_Tp, HF, FF>::~MortonCuckooFilter(void) {
+    TableMemory::release(blocks, size_in_bytes(), pages);
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t MortonCuckooFilter<_Tp, HF, FF>::round_pow2(uint64_t n) noexcept {
+    uint64_t pow2 = 1;
+    while (pow2 < n) {
+        pow2 <<= 1;
+    }
+
+    return pow2;
+}
+
+template <typename _Tp, class HF, class FF>
+size_t MortonCuckooFilter<_Tp, HF, FF>::counter(const MortonBlock& block, const size_t bucket) noexcept {
+    return (block.fca[bucket / 32] >> (2 * (bucket % 32))) bitand 3;
+}
+
+template <typename _Tp, class HF, class FF>
+size_t MortonCuckooFilter<_Tp, HF, FF>::offset(const MortonBlock& block, const size_t bucket) noexcept {
+    const uint64_t low = 0x5555555555555555ULL, high = 0xaaaaaaaaaaaaaaaaULL;
+    size_t sum = 0;
+    uint64_t word = block.fca[0];
+
+    if (bucket >= 32) {
+        sum = __builtin_popcountll(word bitand low) + 2 * __builtin_popcountll(word bitand high);
+        word = block.fca[1];
+    }
+
+    const size_t bits = 2 * (bucket % 32);
+    if (bits) {
+        word &= ~0ULL >> (64 - bits);
+        sum += __builtin_popcountll(word bitand low) + 2 * __builtin_popcountll(word bitand high);
+    }
+
+    return sum;
+}
+
+template <typename _Tp, class HF, class FF>
+size_t MortonCuckooFilter<_Tp, HF, FF>::occupancy(const MortonBlock& block) noexcept {
+    return offset(block, _MORTONBLOCK_BUCKETS - 1) + counter(block, _MORTONBLOCK_BUCKETS - 1);
+}
+
+template <typename _Tp, class HF, class FF>
+uint8_t MortonCuckooFilter<_Tp, HF, FF>::fingerprint_util(const _Tp& key) const noexcept {
+    return fingerprint(key) bitand 0xff;
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t MortonCuckooFilter<_Tp, HF, FF>::alt_index(uint8_t fp, uint64_t bucket) const noexcept {
+    return (bucket ^ ((fp + 1) * 0x5bd1e995ULL)) bitand mask;
+}
+
+template <typename _Tp, class HF, class FF>
+bool MortonCuckooFilter<_Tp, HF, FF>::can_store(uint64_t bucket) const noexcept {
+    const MortonBlock& block = blocks[bucket / _MORTONBLOCK_BUCKETS];
+    return counter(block, bucket % _MORTONBLOCK_BUCKETS) < _MORTONBLOCK_BUCKET_CAPACITY and occupancy(block) < _MORTONBLOCK_SLOTS;
+}
+
+template <typename _Tp, class HF, class FF>
+void MortonCuckooFilter<_Tp, HF, FF>::store(uint8_t fp, uint64_t bucket) noexcept {
+    MortonBlock& block = blocks[bucket / _MORTONBLOCK_BUCKETS];
+    const size_t b = bucket % _MORTONBLOCK_BUCKETS;
+    const size_t pos = offset(block, b) + counter(block, b);
+
+    std::memmove(block.fsa + pos + 1, block.fsa + pos, occupancy(block) - pos);
+    block.fsa[pos] = fp;
+    block.fca[b / 32] += 1ULL << (2 * (b % 32));
+}
+
+template <typename _Tp, class HF, class FF>
+uint8_t MortonCuckooFilter<_Tp, HF, FF>::evict(uint64_t bucket, const size_t i) noexcept {
+    MortonBlock& block = blocks[bucket / _MORTONBLOCK_BUCKETS];
+    const size_t b = bucket % _MORTONBLOCK_BUCKETS;
+    const size_t pos = offset(block, b) + i;
+    const uint8_t fp = block.fsa[pos];
+
+    std::memmove(block.fsa + pos, block.fsa + pos + 1, occupancy(block) - pos - 1);
+    block.fca[b / 32] -= 1ULL << (2 * (b % 32));
+    return fp;
+}
+
+template <typename _Tp, class HF, class FF>
+bool MortonCuckooFilter<_Tp, HF, FF>::bucket_contains(uint8_t fp, uint64_t bucket) const noexcept {
+    const MortonBlock& block = blocks[bucket / _MORTONBLOCK_BUCKETS];
+    const size_t b = bucket % _MORTONBLOCK_BUCKETS;
+    const uint8_t* slots = block.fsa + offset(block, b);
+
+    for (size_t i = counter(block, b); i > 0; i--) {
+        if (slots[i - 1] == fp) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename _Tp, class HF, class FF>
+bool MortonCuckooFilter<_Tp, HF, FF>::bucket_remove(uint8_t fp, uint64_t bucket) noexcept {
+    const MortonBlock& block = blocks[bucket / _MORTONBLOCK_BUCKETS];
+    const size_t b = bucket % _MORTONBLOCK_BUCKETS;
+    const uint8_t* slots = block.fsa + offset(block, b);
+
+    for (size_t i = 0; i < counter(block, b); i++) {
+        if (slots[i] == fp) {
+            evict(bucket, i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename _Tp, class HF, class FF>
+bool MortonCuckooFilter<_Tp, HF, FF>::overflowed(uint64_t bucket) const noexcept {
+    return (blocks[bucket / _MORTONBLOCK_BUCKETS].ota >> (bucket % _MORTONBLOCK_OVERFLOW_BITS)) bitand 1;
+}
+
+template <typename _Tp, class HF, class FF>
+void MortonCuckooFilter<_Tp, HF, FF>::mark_overflow(uint64_t bucket) noexcept {
+    blocks[bucket / _MORTONBLOCK_BUCKETS].ota |= 1 << (bucket % _MORTONBLOCK_OVERFLOW_BITS);
+}
+
+template <typename _Tp, class HF, class FF>
+uint8_t MortonCuckooFilter<_Tp, HF, FF>::insert(const _Tp& key) noexcept {
+    uint8_t fp = fingerprint_util(key);
+    uint64_t _hash = hasher(key) bitand mask;
+
+    if (can_store(_hash)) {
+        store(fp, _hash);
+        key_count++;
+        return _CUCKOOFILTER_INSERTED;
+    }
+
+    uint64_t alt_hash = alt_index(fp, _hash);
+    if (can_store(alt_hash)) {
+        mark_overflow(_hash);
+        store(fp, alt_hash);
+        key_count++;
+        return _CUCKOOFILTER_INSERTED;
+    }
+
+    kick_log.clear();
+    uint64_t target = (prng() % 2) ? _hash : alt_hash;
+    if (target == alt_hash) {
+        mark_overflow(_hash);
+    }
+
+    for (uint32_t count = 0; count < threshold; count++) {
+        const MortonBlock& block = blocks[target / _MORTONBLOCK_BUCKETS];
+        const size_t filled = counter(block, target % _MORTONBLOCK_BUCKETS);
+        if (not filled) {
+            break;
+        }
+
+        uint8_t victim = evict(target, prng() % filled);
+        store(fp, target);
+        kick_log.emplace_back(target, fp);
+
+        fp = victim;
+        uint64_t next = alt_index(fp, target);
+        mark_overflow(target);
+
+        if (can_store(next)) {
+            store(fp, next);
+            key_count++;
+            return _CUCKOOFILTER_INSERTED;
+        }
+
+        target = next;
+    }
+
+    while (not kick_log.empty()) {
+        bucket_remove(kick_log.back().second, kick_log.back().first);
+        store(fp, kick_log.back().first);
+        fp = kick_log.back().second;
+        kick_log.pop_back();
+    }
+
+    failed_count++;
+    return _CUCKOOFILTER_FULL;
+}
+
+template <typename _Tp, class HF, class FF>
+bool MortonCuckooFilter<_Tp, HF, FF>::lookup(const _Tp& key) const noexcept {
+    uint8_t fp = fingerprint_util(key);
+    uint64_t _hash = hasher(key) bitand mask;
+
+    if (bucket_contains(fp, _hash)) {
+        return true;
+    }
+
+    return overflowed(_hash) and bucket_contains(fp, alt_index(fp, _hash));
+}
+
+template <typename _Tp, class HF, class FF>
+bool MortonCuckooFilter<_Tp, HF, FF>::remove(const _Tp& key) noexcept {
+    uint8_t fp = fingerprint_util(key);
+    uint64_t _hash = hasher(key) bitand mask;
+
+    if (bucket_remove(fp, _hash) or (overflowed(_hash) and bucket_remove(fp, alt_index(fp, _hash)))) {
+        key_count--;
+        return true;
+    }
+
+    return false;
+}
+
+template <typename _Tp, class HF, class FF>
+double MortonCuckooFilter<_Tp, HF, FF>::load_factor(void) const noexcept {
+    return double(key_count) / (n_blocks * _MORTONBLOCK_SLOTS);
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t MortonCuckooFilter<_Tp, HF, FF>::num_keys(void) const noexcept {
+    return key_count;
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t MortonCuckooFilter<_Tp, HF, FF>::num_failures(void) const noexcept {
+    return failed_count;
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t MortonCuckooFilter<_Tp, HF, FF>::size_in_bytes(void) const noexcept {
+    return n_blocks * sizeof(MortonBlock);
+}
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 class MurMurHash3 {
     private:
         uint32_t murmurhash3(const void*, const size_t, const uint32_t) const noexcept;
 
     public:
+        static constexpr uint32_t family_id = 1;
+
         MurMurHash3(void);
 
         ~MurMurHash3(void) = default;
@@ -23,6 +26,8 @@ class MurMurHash3 {
 
         uint32_t operator()(const std::string&, const uint32_t = 0) const noexcept;
 
+        uint32_t operator()(std::string_view, const uint32_t = 0) const noexcept;
+
         template <typename _Tp = uint64_t>
         uint32_t operator()(_Tp, const uint32_t = 0) const noexcept;
 };
@@ -101,17 +106,19 @@ uint32_t MurMurHash3::operator()(const std::string& str, const uint32_t seed) co
     return murmurhash3(str.data(), str.length(), seed);
 }
 
+uint32_t MurMurHash3::operator()(std::string_view str, const uint32_t seed) const noexcept {
+    return murmurhash3(str.data(), str.length(), seed);
+}
+
 template <typename _Tp>
 uint32_t MurMurHash3::operator()(_Tp num, const uint32_t seed) const noexcept {
     const size_t len = sizeof(decltype(num));
-    uint8_t* key = new uint8_t[len];
+    uint8_t key[len];
 
     for (size_t i = len; i > 0; i--) {
         key[i - 1] = num bitand 0xff;
         num >>= 8;
     }
 
-    uint32_t hash = murmurhash3(key, len, seed);
-    delete[] key;
-    return hash;
+    return murmurhash3(key, len, seed);
 }
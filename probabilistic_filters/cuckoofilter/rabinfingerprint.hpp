@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 class RabinFingerprint {
     private:
@@ -12,6 +13,8 @@ class RabinFingerprint {
         uint64_t fingerprint(const void*, const size_t) const noexcept;
 
     public:
+        static constexpr uint32_t family_id = 2;
+
         RabinFingerprint(void);
 
         ~RabinFingerprint(void) = default;
@@ -28,8 +31,10 @@ class RabinFingerprint {
 
         uint64_t operator()(const std::string&) const noexcept;
 
+        uint64_t operator()(std::string_view) const noexcept;
+
         template <typename _Tp = uint64_t>
-        uint64_t operator()(const _Tp) const noexcept;
+        uint64_t operator()(_Tp) const noexcept;
 };
 
 RabinFingerprint::RabinFingerprint(void)
@@ -94,17 +99,19 @@ uint64_t RabinFingerprint::operator()(const std::string& str) const noexcept {
     return fingerprint(str.data(), str.length());
 }
 
+uint64_t RabinFingerprint::operator()(std::string_view str) const noexcept {
+    return fingerprint(str.data(), str.length());
+}
+
 template <typename _Tp>
-uint64_t RabinFingerprint::operator()(const _Tp num) const noexcept {
+uint64_t RabinFingerprint::operator()(_Tp num) const noexcept {
     const size_t len = sizeof(decltype(num));
-    uint8_t* key = new uint8_t[len];
+    uint8_t key[len];
 
     for (size_t i = len; i > 0; i--) {
         key[i - 1] = num bitand 0xff;
         num >>= 8;
     }
 
-    uint32_t fp = fingerprint(key, len);
-    delete[] key;
-    return fp;
+    return uint32_t(fingerprint(key, len));
 }
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "murmurhash3.hpp"
+#include "cuckoofilter.hpp"
+#include "dynamiccuckoofilter.hpp"
+using namespace std;
+
+class NarrowFingerprint {
+    public:
+        static constexpr uint32_t family_id = 0xff;
+
+        uint64_t operator()(const int key) const noexcept {
+            return MurMurHash3()(key, 0x5bd1e995) bitand 7;
+        }
+};
+
+template <class Filter>
+void check_no_false_negatives(Filter& cuckoo, mt19937& rng) {
+    vector<int> present;
+    for (int step = 0; step < 400; step++) {
+        if (present.empty() or rng() % 3) {
+            int key = int(rng() % 100000);
+            if (find(present.begin(), present.end(), key) == present.end() and cuckoo.insert(key) != _CUCKOOFILTER_FULL) {
+                present.push_back(key);
+            }
+        }
+
+        else {
+            size_t victim = rng() % present.size();
+            assert(cuckoo.remove(present[victim]));
+            present[victim] = present.back();
+            present.pop_back();
+        }
+
+        for (int key : present) {
+            assert(cuckoo.lookup(key));
+        }
+    }
+}
+
+void test_stash_remove_ll(void) {
+    for (uint32_t seed = 1; seed <= 200; seed++) {
+        mt19937 rng(seed);
+        CuckooFilterLL<int, MurMurHash3, NarrowFingerprint> cuckoo(16, 8, 0.9);
+        check_no_false_negatives(cuckoo, rng);
+    }
+}
+
+void test_stash_remove_hl(void) {
+    for (uint32_t seed = 1; seed <= 200; seed++) {
+        mt19937 rng(seed);
+        CuckooFilterHL<int, MurMurHash3, NarrowFingerprint> cuckoo(8, 8, 2);
+        check_no_false_negatives(cuckoo, rng);
+    }
+}
+
+void test_stash_remove_dynamic(void) {
+    for (uint32_t seed = 1; seed <= 100; seed++) {
+        mt19937 rng(seed);
+        DynamicCuckooFilter<int, MurMurHash3, NarrowFingerprint> cuckoo(8, 8, 2);
+        check_no_false_negatives(cuckoo, rng);
+    }
+}
+
+int main(void) {
+    test_stash_remove_ll();
+    test_stash_remove_hl();
+    test_stash_remove_dynamic();
+
+    cout << "cuckoofilter regression tests passed\n";
+    return 0;
+}
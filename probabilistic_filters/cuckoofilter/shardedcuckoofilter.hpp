@@ -0,0 +1,271 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+#include "cuckoofilter.hpp"
+
+#ifndef _SHARDEDCUCKOOFILTER_SHARD_SEED
+    #define _SHARDEDCUCKOOFILTER_SHARD_SEED 0x9e3779b9
+#endif
+
+template <typename _Tp, class HashFamily, class FingerprintFamily>
+class ShardedCuckooFilter {
+    private:
+        typedef CuckooFilterHL<_Tp, HashFamily, FingerprintFamily> Shard;
+        typedef std::vector<std::pair<const _Tp*, uint32_t>> Route;
+
+        const size_t n_shards;
+        const uint32_t shard_bits;
+
+        std::vector<Shard*> shards;
+
+        std::vector<std::thread> workers;
+        std::mutex pool_lock;
+        std::condition_variable pool_wake;
+        std::condition_variable pool_done;
+        std::function<void(size_t)> job;
+        uint64_t generation;
+        size_t active;
+        size_t pending;
+        bool stopping;
+
+        const HashFamily hasher;
+
+        static size_t round_pow2(size_t) noexcept;
+
+        size_t shard_of(const _Tp&) const noexcept;
+
+        void spawn(const size_t);
+
+        void work(const size_t, uint64_t) noexcept;
+
+        void run(const size_t, const std::function<void(size_t)>&);
+
+    public:
+        explicit ShardedCuckooFilter(const uint64_t, const uint32_t, const size_t, const size_t = 4, const uint8_t = _TABLEMEMORY_DEFAULT_PAGES);
+
+        ShardedCuckooFilter(const ShardedCuckooFilter&) = delete;
+
+        ShardedCuckooFilter& operator=(const ShardedCuckooFilter&) = delete;
+
+        ~ShardedCuckooFilter(void);
+
+        uint8_t insert(const _Tp&) noexcept;
+
+        uint64_t bulk_load(const _Tp*, const size_t, size_t = 0);
+
+        bool lookup(const _Tp&) const noexcept;
+
+        bool remove(const _Tp&) noexcept;
+
+        double load_factor(void) const noexcept;
+
+        uint64_t num_keys(void) const noexcept;
+
+        uint64_t num_failures(void) const noexcept;
+
+        size_t num_shards(void) const noexcept;
+
+        uint64_t size_in_bytes(void) const noexcept;
+};
+
+template <typename _Tp, class HF, class FF>
+ShardedCuckooFilter<_Tp, HF, FF>::ShardedCuckooFilter(const uint64_t size, const uint32_t relocation_threshold, const size_t shards, const size_t buckets, const uint8_t pages)
+    : n_shards(round_pow2(shards)), shard_bits(__builtin_ctzll(round_pow2(shards))),
+    generation(0), active(0), pending(0), stopping(false), hasher() {
+
+    for (size_t s = 0; s < n_shards; s++) {
+        this->shards.push_back(new Shard((size + n_shards - 1) / n_shards, relocation_threshold, buckets, pages));
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+ShardedCuckooFilter<_Tp, HF, FF>::~ShardedCuckooFilter(void) {
+    {
+        std::lock_guard<std::mutex> guard(pool_lock);
+        stopping = true;
+    }
+
+    pool_wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (Shard* shard : shards) {
+        delete shard;
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+size_t ShardedCuckooFilter<_Tp, HF, FF>::round_pow2(size_t n) noexcept {
+    size_t pow2 = 1;
+    while (pow2 < n) {
+        pow2 <<= 1;
+    }
+
+    return pow2;
+}
+
+template <typename _Tp, class HF, class FF>
+size_t ShardedCuckooFilter<_Tp, HF, FF>::shard_of(const _Tp& key) const noexcept {
+    return shard_bits ? hasher(key, _SHARDEDCUCKOOFILTER_SHARD_SEED) >> (32 - shard_bits) : 0;
+}
+
+template <typename _Tp, class HF, class FF>
+void ShardedCuckooFilter<_Tp, HF, FF>::spawn(const size_t n_workers) {
+    std::lock_guard<std::mutex> guard(pool_lock);
+    while (workers.size() < n_workers) {
+        workers.emplace_back(&ShardedCuckooFilter::work, this, workers.size() + 1, generation);
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+void ShardedCuckooFilter<_Tp, HF, FF>::work(const size_t id, uint64_t seen) noexcept {
+    std::unique_lock<std::mutex> guard(pool_lock);
+
+    while (true) {
+        pool_wake.wait(guard, [&]() { return stopping or generation != seen; });
+        if (stopping) {
+            return;
+        }
+
+        seen = generation;
+        if (id >= active) {
+            continue;
+        }
+
+        guard.unlock();
+        job(id);
+        guard.lock();
+
+        if (not --pending) {
+            pool_done.notify_one();
+        }
+    }
+}
+
+template <typename _Tp, class HF, class FF>
+void ShardedCuckooFilter<_Tp, HF, FF>::run(const size_t n_threads, const std::function<void(size_t)>& task) {
+    spawn(n_threads - 1);
+
+    {
+        std::lock_guard<std::mutex> guard(pool_lock);
+        job = task;
+        active = n_threads;
+        pending = n_threads - 1;
+        generation++;
+    }
+
+    pool_wake.notify_all();
+    job(0);
+
+    std::unique_lock<std::mutex> guard(pool_lock);
+    pool_done.wait(guard, [&]() { return not pending; });
+}
+
+template <typename _Tp, class HF, class FF>
+uint8_t ShardedCuckooFilter<_Tp, HF, FF>::insert(const _Tp& key) noexcept {
+    return shards[shard_of(key)]->insert(key);
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t ShardedCuckooFilter<_Tp, HF, FF>::bulk_load(const _Tp* keys, const size_t count, size_t n_threads) {
+    if (not n_threads) {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<std::vector<Route>> routes(n_threads, std::vector<Route>(n_shards));
+
+    run(n_threads, [&](const size_t t) {
+        const size_t first = count * t / n_threads, last = count * (t + 1) / n_threads;
+        for (size_t i = first; i < last; i++) {
+            routes[t][shard_of(keys[i])].emplace_back(keys + i, hasher(keys[i]));
+        }
+    });
+
+    std::atomic<size_t> next_shard(0);
+    std::atomic<uint64_t> inserted(0);
+
+    run(n_threads, [&](const size_t) {
+        uint64_t local = 0;
+        for (size_t s = next_shard++; s < n_shards; s = next_shard++) {
+            Shard* shard = shards[s];
+
+            for (size_t r = 0; r < n_threads; r++) {
+                for (const std::pair<const _Tp*, uint32_t>& entry : routes[r][s]) {
+                    uint64_t fp = shard->fingerprint(*entry.first);
+                    fp += (fp == 0);
+
+                    if (shard->insert_util(fp, entry.second & shard->mask, 0) != _CUCKOOFILTER_FULL) {
+                        shard->key_count++;
+                        local++;
+                    }
+                }
+            }
+        }
+
+        inserted += local;
+    });
+
+    return inserted;
+}
+
+template <typename _Tp, class HF, class FF>
+bool ShardedCuckooFilter<_Tp, HF, FF>::lookup(const _Tp& key) const noexcept {
+    return shards[shard_of(key)]->lookup(key);
+}
+
+template <typename _Tp, class HF, class FF>
+bool ShardedCuckooFilter<_Tp, HF, FF>::remove(const _Tp& key) noexcept {
+    return shards[shard_of(key)]->remove(key);
+}
+
+template <typename _Tp, class HF, class FF>
+double ShardedCuckooFilter<_Tp, HF, FF>::load_factor(void) const noexcept {
+    uint64_t slots = 0;
+    for (const Shard* shard : shards) {
+        slots += shard->size * shard->n_buckets;
+    }
+
+    return double(num_keys()) / slots;
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t ShardedCuckooFilter<_Tp, HF, FF>::num_keys(void) const noexcept {
+    uint64_t count = 0;
+    for (const Shard* shard : shards) {
+        count += shard->num_keys();
+    }
+
+    return count;
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t ShardedCuckooFilter<_Tp, HF, FF>::num_failures(void) const noexcept {
+    uint64_t count = 0;
+    for (const Shard* shard : shards) {
+        count += shard->num_failures();
+    }
+
+    return count;
+}
+
+template <typename _Tp, class HF, class FF>
+size_t ShardedCuckooFilter<_Tp, HF, FF>::num_shards(void) const noexcept {
+    return n_shards;
+}
+
+template <typename _Tp, class HF, class FF>
+uint64_t ShardedCuckooFilter<_Tp, HF, FF>::size_in_bytes(void) const noexcept {
+    uint64_t bytes = 0;
+    for (const Shard* shard : shards) {
+        bytes += shard->size_in_bytes();
+    }
+
+    return bytes;
+}
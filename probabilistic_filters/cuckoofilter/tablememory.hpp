@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifndef _TABLEMEMORY_DEFAULT_PAGES
+    #define _TABLEMEMORY_DEFAULT_PAGES 0
+#endif
+
+#ifndef _TABLEMEMORY_TRANSPARENT_HUGE_PAGES
+    #define _TABLEMEMORY_TRANSPARENT_HUGE_PAGES 1
+#endif
+
+#ifndef _TABLEMEMORY_EXPLICIT_HUGE_PAGES
+    #define _TABLEMEMORY_EXPLICIT_HUGE_PAGES 2
+#endif
+
+#ifndef _TABLEMEMORY_MAPPED
+    #define _TABLEMEMORY_MAPPED 3
+#endif
+
+#ifndef _TABLEMEMORY_CACHE_LINE
+    #define _TABLEMEMORY_CACHE_LINE 64
+#endif
+
+#ifndef _TABLEMEMORY_HUGE_PAGE
+    #define _TABLEMEMORY_HUGE_PAGE (2 << 20)
+#endif
+
+class TableMemory {
+    private:
+        static size_t round_up(const size_t, const size_t) noexcept;
+
+    public:
+        static void* allocate(const size_t, uint8_t&);
+
+        static void* map(const std::string&, const size_t, const size_t, const bool, uint8_t&);
+
+        static void release(void*, const size_t, const uint8_t) noexcept;
+};
+
+inline size_t TableMemory::round_up(const size_t bytes, const size_t alignment) noexcept {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+inline void* TableMemory::allocate(const size_t bytes, uint8_t& pages) {
+#if defined(__linux__)
+    if (pages == _TABLEMEMORY_EXPLICIT_HUGE_PAGES) {
+        void* mem = mmap(nullptr, round_up(bytes, _TABLEMEMORY_HUGE_PAGE), PROT_READ bitor PROT_WRITE,
+            MAP_PRIVATE bitor MAP_ANONYMOUS bitor MAP_HUGETLB, -1, 0);
+
+        if (mem != MAP_FAILED) {
+            return mem;
+        }
+
+        pages = _TABLEMEMORY_TRANSPARENT_HUGE_PAGES;
+    }
+
+    if (pages == _TABLEMEMORY_TRANSPARENT_HUGE_PAGES and bytes >= _TABLEMEMORY_HUGE_PAGE) {
+        void* mem = aligned_alloc(_TABLEMEMORY_HUGE_PAGE, round_up(bytes, _TABLEMEMORY_HUGE_PAGE));
+        if (mem == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        madvise(mem, round_up(bytes, _TABLEMEMORY_HUGE_PAGE), MADV_HUGEPAGE);
+        std::memset(mem, 0, bytes);
+        return mem;
+    }
+#endif
+
+    pages = _TABLEMEMORY_DEFAULT_PAGES;
+
+    void* mem = aligned_alloc(_TABLEMEMORY_CACHE_LINE, round_up(bytes, _TABLEMEMORY_CACHE_LINE));
+    if (mem == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    std::memset(mem, 0, bytes);
+    return mem;
+}
+
+inline void* TableMemory::map(const std::string& path, const size_t offset, const size_t bytes, const bool copy_on_write, uint8_t& pages) {
+#if defined(__linux__)
+    if (offset % sysconf(_SC_PAGESIZE) == 0) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("failed to open file: " + path);
+        }
+
+        void* mem = mmap(nullptr, bytes, copy_on_write ? PROT_READ bitor PROT_WRITE : PROT_READ,
+            copy_on_write ? MAP_PRIVATE : MAP_SHARED, fd, offset);
+        close(fd);
+
+        if (mem != MAP_FAILED) {
+            pages = _TABLEMEMORY_MAPPED;
+            return mem;
+        }
+    }
+#endif
+
+    pages = _TABLEMEMORY_DEFAULT_PAGES;
+    void* mem = allocate(bytes, pages);
+
+    std::fstream file(path.c_str(), std::ios_base::in bitor std::ios_base::binary);
+    file.seekg(offset);
+    if (not file.read((char*) mem, bytes)) {
+        release(mem, bytes, pages);
+        throw std::runtime_error("truncated file: " + path);
+    }
+
+    return mem;
+}
+
+inline void TableMemory::release(void* mem, const size_t bytes, const uint8_t pages) noexcept {
+    if (mem == nullptr) {
+        return;
+    }
+
+#if defined(__linux__)
+    if (pages == _TABLEMEMORY_EXPLICIT_HUGE_PAGES) {
+        munmap(mem, round_up(bytes, _TABLEMEMORY_HUGE_PAGE));
+        return;
+    }
+
+    if (pages == _TABLEMEMORY_MAPPED) {
+        munmap(mem, bytes);
+        return;
+    }
+#endif
+
+    free(mem);
+}
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include "murmurhash3.hpp"
+#include "quotientfilter.hpp"
+using namespace std;
+
+vector<string> read_keys(const string& filename, uint64_t limit) {
+    fstream file(filename.c_str(), ios_base::in);
+    if (not file.good()) {
+        file.close();
+        throw fstream::failure("failed to open file");
+    }
+
+    vector<string> keys;
+    string line;
+    while (getline(file, line) and limit--) {
+        keys.push_back(line);
+    }
+
+    file.close();
+    return keys;
+}
+
+uint64_t count_missing(const QuotientFilter<string, MurMurHash3>& quotient, const vector<string>& keys) {
+    uint64_t missing = 0;
+    for (const string& key : keys) {
+        missing += not quotient.lookup(key);
+    }
+
+    return missing;
+}
+
+void benchmark(const vector<string>& keys, const uint8_t remainder_bits) {
+    using namespace std::chrono;
+
+    QuotientFilter<string, MurMurHash3> quotient(keys.size(), remainder_bits);
+
+    std::cout << "\npopulating the filter ... ";
+    steady_clock::time_point start = steady_clock::now();
+    for (const string& key : keys) {
+        quotient.insert(key);
+    }
+    double time = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    std::cout << "done\n";
+
+    uint64_t false_positives = 0;
+    const uint64_t probes = 100000;
+    start = steady_clock::now();
+    for (uint64_t i = 0; i < probes; i++) {
+        false_positives += quotient.lookup("#" + to_string(i));
+    }
+    double lookup_time = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    std::cout << "\nnumber of keys\t\t\t: " << quotient.num_keys();
+    std::cout << "\nsize of filter (bytes)\t\t: " << quotient.size_in_bytes();
+    std::cout << "\naverage size per key (bytes)\t: " << (double)quotient.size_in_bytes() / quotient.num_keys();
+    std::cout << "\nload factor\t\t\t: " << 100 * quotient.load_factor() << " %";
+    std::cout << "\naverage key insertion time\t: " << time / keys.size() << " ns";
+    std::cout << "\naverage lookup time\t\t: " << lookup_time / probes << " ns";
+    std::cout << "\nfalse positive rate\t\t: " << 100.0 * false_positives / probes << " %";
+    std::cout << "\nmissing keys\t\t\t: " << count_missing(quotient, keys) << "\n";
+
+    start = steady_clock::now();
+    quotient.resize();
+    time = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+    std::cout << "\nresize to " << quotient.num_slots() << " slots\t: " << time << " ms (load factor " << 100 * quotient.load_factor();
+    std::cout << " %, fingerprint bits " << (int) quotient.fingerprint_bits() << ", missing keys " << count_missing(quotient, keys) << ")";
+
+    QuotientFilter<string, MurMurHash3> older(keys.size() / 2, remainder_bits), newer(keys.size() / 2, remainder_bits);
+    for (size_t i = 0; i < keys.size(); i++) {
+        (i < keys.size() / 2 ? older : newer).insert(keys[i]);
+    }
+
+    start = steady_clock::now();
+    older.merge(newer);
+    time = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+    std::cout << "\nmerge of two halves\t\t: " << time << " ms (" << older.num_keys() << " keys, missing keys " << count_missing(older, keys) << ")\n";
+
+    string input;
+    while (true) {
+        std::cout << "\nlookup password: ";
+        std::cin.sync();
+        getline(std::cin, input);
+
+        if (input == "exit") {
+            break;
+        }
+
+        start = steady_clock::now();
+        uint64_t count = quotient.count(input);
+        time = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+        if (count) {
+            std::cout << "password is common (seen " << count << " times)";
+        }
+        else {
+            std::cout << "password is unique";
+        }
+
+        std::cout << " (operation time: " << time << " nanoseconds)\n";
+        input.clear();
+    }
+}
+
+int main(void) {
+    string filename;
+    cout << "enter dictionary path: ";
+    cin >> filename;
+
+    try {
+        uint64_t limit;
+        int remainder_bits;
+
+        cout << "\nupper limit on keys: ";
+        cin >> limit;
+
+        cout << "remainder bits (2 - 16): ";
+        cin >> remainder_bits;
+        cin.ignore();
+
+        cout << "\nreading file ...\n";
+        vector<string> keys = read_keys(filename, limit);
+        benchmark(keys, remainder_bits);
+        return 0;
+    }
+
+    catch (const exception& exc) {
+        cerr << exc.what() << endl;
+        return 1;
+    }
+}
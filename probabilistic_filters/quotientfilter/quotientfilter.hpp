@@ -0,0 +1,546 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__BMI2__)
+    #include <immintrin.h>
+#endif
+
+#ifndef _QUOTIENTFILTER_INSERTED
+    #define _QUOTIENTFILTER_INSERTED 0
+#endif
+
+#ifndef _QUOTIENTFILTER_FULL
+    #define _QUOTIENTFILTER_FULL 1
+#endif
+
+#ifndef _QUOTIENTFILTER_BLOCK_SLOTS
+    #define _QUOTIENTFILTER_BLOCK_SLOTS 64
+#endif
+
+#ifndef _QUOTIENTFILTER_MAX_LOAD
+    #define _QUOTIENTFILTER_MAX_LOAD 0.95
+#endif
+
+#ifndef _QUOTIENTFILTER_SEED_HIGH
+    #define _QUOTIENTFILTER_SEED_HIGH 0x9747b28c
+#endif
+
+#ifndef _QUOTIENTFILTER_SEED_LOW
+    #define _QUOTIENTFILTER_SEED_LOW 0x2f5a1e3b
+#endif
+
+struct QuotientBlock {
+    uint32_t offset;
+    uint64_t occupieds;
+    uint64_t runends;
+    uint16_t remainders[_QUOTIENTFILTER_BLOCK_SLOTS];
+};
+
+template <typename _Tp, class HashFamily>
+class QuotientFilter {
+    private:
+        uint8_t q_bits;
+        uint8_t r_bits;
+        uint64_t n_slots;
+        uint64_t n_blocks;
+        uint64_t key_count;
+
+        QuotientBlock* blocks;
+
+        const HashFamily hasher;
+
+        static uint64_t low_mask(const uint64_t) noexcept;
+
+        static uint64_t select_word(uint64_t, uint64_t) noexcept;
+
+        static uint64_t blocks_for(const uint8_t) noexcept;
+
+        uint64_t fingerprint(const _Tp&) const noexcept;
+
+        bool occupied(const uint64_t) const noexcept;
+
+        bool runend(const uint64_t) const noexcept;
+
+        uint16_t& remainder(const uint64_t) noexcept;
+
+        uint16_t remainder(const uint64_t) const noexcept;
+
+        void set_occupied(const uint64_t, const bool) noexcept;
+
+        void set_runend(const uint64_t, const bool) noexcept;
+
+        int64_t select_runend(uint64_t, uint64_t) const noexcept;
+
+        int64_t runend_or_prev(const uint64_t) const noexcept;
+
+        uint64_t run_start(const uint64_t) const noexcept;
+
+        uint64_t first_empty(uint64_t) const noexcept;
+
+        uint64_t next_occupied(const uint64_t, const uint64_t) const noexcept;
+
+        void update_offsets(const uint64_t, const uint64_t) noexcept;
+
+        void shift_right(const uint64_t, const uint64_t) noexcept;
+
+        void shift_left(const uint64_t, const uint64_t) noexcept;
+
+        template <class Visitor>
+        void for_each(Visitor) const;
+
+        void rebuild(const uint8_t, const QuotientFilter*, const QuotientFilter*);
+
+    public:
+        explicit QuotientFilter(const uint64_t, const uint8_t = 8);
+
+        QuotientFilter(const QuotientFilter&) = delete;
+
+        QuotientFilter& operator=(const QuotientFilter&) = delete;
+
+        ~QuotientFilter(void);
+
+        uint8_t insert(const _Tp&) noexcept;
+
+        bool lookup(const _Tp&) const noexcept;
+
+        uint64_t count(const _Tp&) const noexcept;
+
+        bool remove(const _Tp&) noexcept;
+
+        void resize(void);
+
+        void merge(const QuotientFilter&);
+
+        double load_factor(void) const noexcept;
+
+        uint64_t num_keys(void) const noexcept;
+
+        uint64_t num_slots(void) const noexcept;
+
+        uint8_t fingerprint_bits(void) const noexcept;
+
+        uint64_t size_in_bytes(void) const noexcept;
+};
+
+template <typename _Tp, class HF>
+QuotientFilter<_Tp, HF>::QuotientFilter(const uint64_t capacity, const uint8_t remainder_bits)
+    : q_bits(std::max(6.0, ceil(log2(capacity / _QUOTIENTFILTER_MAX_LOAD)))), r_bits(remainder_bits), key_count(0), hasher() {
+    if (r_bits < 2 or r_bits > 16 or q_bits + r_bits > 64) {
+        throw std::invalid_argument("invalid remainder width: " + std::to_string(remainder_bits));
+    }
+
+    n_slots = 1ULL << q_bits;
+    n_blocks = blocks_for(q_bits);
+    blocks = new QuotientBlock[n_blocks]();
+}
+
+template <typename _Tp, class HF>
+QuotientFilter<_Tp, HF>::~QuotientFilter(void) {
+    delete[] blocks;
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::low_mask(const uint64_t bits) noexcept {
+    return bits >= 64 ? ~0ULL : (1ULL << bits) - 1;
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::select_word(uint64_t word, uint64_t rank) noexcept {
+#if defined(__BMI2__)
+    return __builtin_ctzll(_pdep_u64(1ULL << rank, word));
+#else
+    for (; rank; rank--) {
+        word &= word - 1;
+    }
+
+    return __builtin_ctzll(word);
+#endif
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::blocks_for(const uint8_t q_bits) noexcept {
+    const uint64_t slots = 1ULL << q_bits;
+    const uint64_t extra = 10 * sqrt(slots) + _QUOTIENTFILTER_BLOCK_SLOTS;
+    return (slots + extra + _QUOTIENTFILTER_BLOCK_SLOTS - 1) / _QUOTIENTFILTER_BLOCK_SLOTS;
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::fingerprint(const _Tp& key) const noexcept {
+    uint64_t _hash = (uint64_t(hasher(key, _QUOTIENTFILTER_SEED_HIGH)) << 32) bitor hasher(key, _QUOTIENTFILTER_SEED_LOW);
+    return _hash bitand low_mask(q_bits + r_bits);
+}
+
+template <typename _Tp, class HF>
+bool QuotientFilter<_Tp, HF>::occupied(const uint64_t i) const noexcept {
+    return (blocks[i / _QUOTIENTFILTER_BLOCK_SLOTS].occupieds >> (i % _QUOTIENTFILTER_BLOCK_SLOTS)) bitand 1;
+}
+
+template <typename _Tp, class HF>
+bool QuotientFilter<_Tp, HF>::runend(const uint64_t i) const noexcept {
+    return (blocks[i / _QUOTIENTFILTER_BLOCK_SLOTS].runends >> (i % _QUOTIENTFILTER_BLOCK_SLOTS)) bitand 1;
+}
+
+template <typename _Tp, class HF>
+uint16_t& QuotientFilter<_Tp, HF>::remainder(const uint64_t i) noexcept {
+    return blocks[i / _QUOTIENTFILTER_BLOCK_SLOTS].remainders[i % _QUOTIENTFILTER_BLOCK_SLOTS];
+}
+
+template <typename _Tp, class HF>
+uint16_t QuotientFilter<_Tp, HF>::remainder(const uint64_t i) const noexcept {
+    return blocks[i / _QUOTIENTFILTER_BLOCK_SLOTS].remainders[i % _QUOTIENTFILTER_BLOCK_SLOTS];
+}
+
+template <typename _Tp, class HF>
+void QuotientFilter<_Tp, HF>::set_occupied(const uint64_t i, const bool value) noexcept {
+    uint64_t& word = blocks[i / _QUOTIENTFILTER_BLOCK_SLOTS].occupieds;
+    word = (word bitand ~(1ULL << (i % _QUOTIENTFILTER_BLOCK_SLOTS))) bitor (uint64_t(value) << (i % _QUOTIENTFILTER_BLOCK_SLOTS));
+}
+
+template <typename _Tp, class HF>
+void QuotientFilter<_Tp, HF>::set_runend(const uint64_t i, const bool value) noexcept {
+    uint64_t& word = blocks[i / _QUOTIENTFILTER_BLOCK_SLOTS].runends;
+    word = (word bitand ~(1ULL << (i % _QUOTIENTFILTER_BLOCK_SLOTS))) bitor (uint64_t(value) << (i % _QUOTIENTFILTER_BLOCK_SLOTS));
+}
+
+template <typename _Tp, class HF>
+int64_t QuotientFilter<_Tp, HF>::select_runend(uint64_t from, uint64_t rank) const noexcept {
+    uint64_t b = from / _QUOTIENTFILTER_BLOCK_SLOTS;
+    uint64_t word = blocks[b].runends bitand (~0ULL << (from % _QUOTIENTFILTER_BLOCK_SLOTS));
+
+    while (true) {
+        const uint64_t ones = __builtin_popcountll(word);
+        if (ones >= rank) {
+            return b * _QUOTIENTFILTER_BLOCK_SLOTS + select_word(word, rank - 1);
+        }
+
+        rank -= ones;
+        if (++b == n_blocks) {
+            return n_blocks * _QUOTIENTFILTER_BLOCK_SLOTS;
+        }
+
+        word = blocks[b].runends;
+    }
+}
+
+template <typename _Tp, class HF>
+int64_t QuotientFilter<_Tp, HF>::runend_or_prev(const uint64_t x) const noexcept {
+    const uint64_t b = x / _QUOTIENTFILTER_BLOCK_SLOTS;
+    const uint64_t start = b * _QUOTIENTFILTER_BLOCK_SLOTS + blocks[b].offset;
+    const uint64_t rank = __builtin_popcountll(blocks[b].occupieds bitand low_mask(x % _QUOTIENTFILTER_BLOCK_SLOTS + 1));
+
+    if (not rank) {
+        return int64_t(start) - 1;
+    }
+
+    return select_runend(start, rank);
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::run_start(const uint64_t x) const noexcept {
+    return x ? std::max<int64_t>(x, runend_or_prev(x - 1) + 1) : 0;
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::first_empty(uint64_t i) const noexcept {
+    while (i < n_blocks * _QUOTIENTFILTER_BLOCK_SLOTS) {
+        const int64_t end = runend_or_prev(i);
+        if (end < int64_t(i)) {
+            break;
+        }
+
+        i = end + 1;
+    }
+
+    return i;
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::next_occupied(const uint64_t x, const uint64_t limit) const noexcept {
+    for (uint64_t b = (x + 1) / _QUOTIENTFILTER_BLOCK_SLOTS; b < n_blocks and b * _QUOTIENTFILTER_BLOCK_SLOTS <= limit; b++) {
+        uint64_t word = blocks[b].occupieds;
+        if (b == (x + 1) / _QUOTIENTFILTER_BLOCK_SLOTS) {
+            word &= ~0ULL << ((x + 1) % _QUOTIENTFILTER_BLOCK_SLOTS);
+        }
+
+        if (word) {
+            return std::min(limit + 1, b * _QUOTIENTFILTER_BLOCK_SLOTS + __builtin_ctzll(word));
+        }
+    }
+
+    return limit + 1;
+}
+
+template <typename _Tp, class HF>
+void QuotientFilter<_Tp, HF>::update_offsets(const uint64_t lo, const uint64_t hi) noexcept {
+    for (uint64_t b = lo / _QUOTIENTFILTER_BLOCK_SLOTS + 1; b <= hi / _QUOTIENTFILTER_BLOCK_SLOTS and b < n_blocks; b++) {
+        const int64_t start = b * _QUOTIENTFILTER_BLOCK_SLOTS;
+        blocks[b].offset = std::max<int64_t>(0, runend_or_prev(start - 1) + 1 - start);
+    }
+}
+
+template <typename _Tp, class HF>
+void QuotientFilter<_Tp, HF>::shift_right(const uint64_t from, const uint64_t empty) noexcept {
+    for (uint64_t i = empty; i > from; i--) {
+        remainder(i) = remainder(i - 1);
+        set_runend(i, runend(i - 1));
+    }
+}
+
+template <typename _Tp, class HF>
+void QuotientFilter<_Tp, HF>::shift_left(const uint64_t to, const uint64_t last) noexcept {
+    for (uint64_t i = to; i < last; i++) {
+        remainder(i) = remainder(i + 1);
+        set_runend(i, runend(i + 1));
+    }
+
+    remainder(last) = 0;
+    set_runend(last, false);
+}
+
+template <typename _Tp, class HF>
+template <class Visitor>
+void QuotientFilter<_Tp, HF>::for_each(Visitor visit) const {
+    int64_t last_end = -1;
+
+    for (uint64_t b = 0; b < n_blocks; b++) {
+        for (uint64_t word = blocks[b].occupieds; word; word &= word - 1) {
+            const uint64_t q = b * _QUOTIENTFILTER_BLOCK_SLOTS + __builtin_ctzll(word);
+            const uint64_t start = std::max<int64_t>(q, last_end + 1);
+            last_end = select_runend(start, 1);
+
+            for (uint64_t i = start; i <= uint64_t(last_end); i++) {
+                visit((q << r_bits) bitor remainder(i));
+            }
+        }
+    }
+}
+
+template <typename _Tp, class HF>
+void QuotientFilter<_Tp, HF>::rebuild(const uint8_t new_q_bits, const QuotientFilter* first, const QuotientFilter* second) {
+    const uint8_t fp_bits = q_bits + r_bits;
+    std::vector<uint64_t> fps;
+    fps.reserve(first->key_count + (second ? second->key_count : 0));
+
+    first->for_each([&](uint64_t fp) { fps.push_back(fp); });
+    if (second) {
+        const uint64_t split = fps.size();
+        second->for_each([&](uint64_t fp) { fps.push_back(fp); });
+        std::inplace_merge(fps.begin(), fps.begin() + split, fps.end());
+    }
+
+    QuotientBlock* old_blocks = blocks;
+    q_bits = new_q_bits;
+    r_bits = fp_bits - new_q_bits;
+    n_slots = 1ULL << q_bits;
+    n_blocks = blocks_for(q_bits);
+    blocks = new QuotientBlock[n_blocks]();
+    delete[] old_blocks;
+
+    uint64_t pos = 0;
+    for (size_t k = 0; k < fps.size(); k++) {
+        const uint64_t q = fps[k] >> r_bits;
+        if (k == 0 or q != fps[k - 1] >> r_bits) {
+            pos = std::max(pos, q);
+            set_occupied(q, true);
+        }
+
+        remainder(pos) = fps[k] bitand low_mask(r_bits);
+        if (k + 1 == fps.size() or q != fps[k + 1] >> r_bits) {
+            set_runend(pos, true);
+        }
+
+        pos++;
+    }
+
+    key_count = fps.size();
+    update_offsets(0, n_blocks * _QUOTIENTFILTER_BLOCK_SLOTS);
+}
+
+template <typename _Tp, class HF>
+uint8_t QuotientFilter<_Tp, HF>::insert(const _Tp& key) noexcept {
+    if (key_count >= _QUOTIENTFILTER_MAX_LOAD * n_slots) {
+        return _QUOTIENTFILTER_FULL;
+    }
+
+    const uint64_t fp = fingerprint(key);
+    const uint64_t q = fp >> r_bits;
+    const uint16_t r = fp bitand low_mask(r_bits);
+
+    uint64_t pos;
+    if (occupied(q)) {
+        const uint64_t end = runend_or_prev(q);
+        pos = run_start(q);
+        while (pos <= end and remainder(pos) <= r) {
+            pos++;
+        }
+
+        const uint64_t empty = first_empty(pos);
+        if (empty >= n_blocks * _QUOTIENTFILTER_BLOCK_SLOTS) {
+            return _QUOTIENTFILTER_FULL;
+        }
+
+        shift_right(pos, empty);
+        remainder(pos) = r;
+        set_runend(pos, pos == end + 1);
+        if (pos == end + 1) {
+            set_runend(end, false);
+        }
+
+        update_offsets(q, empty);
+    }
+
+    else {
+        pos = std::max<int64_t>(q, runend_or_prev(q) + 1);
+
+        const uint64_t empty = first_empty(pos);
+        if (empty >= n_blocks * _QUOTIENTFILTER_BLOCK_SLOTS) {
+            return _QUOTIENTFILTER_FULL;
+        }
+
+        shift_right(pos, empty);
+        remainder(pos) = r;
+        set_runend(pos, true);
+        set_occupied(q, true);
+        update_offsets(q, empty);
+    }
+
+    key_count++;
+    return _QUOTIENTFILTER_INSERTED;
+}
+
+template <typename _Tp, class HF>
+bool QuotientFilter<_Tp, HF>::lookup(const _Tp& key) const noexcept {
+    const uint64_t fp = fingerprint(key);
+    const uint64_t q = fp >> r_bits;
+    const uint16_t r = fp bitand low_mask(r_bits);
+
+    if (not occupied(q)) {
+        return false;
+    }
+
+    for (uint64_t i = runend_or_prev(q); i >= q and remainder(i) >= r; i--) {
+        if (remainder(i) == r) {
+            return true;
+        }
+
+        if (i == 0 or runend(i - 1)) {
+            break;
+        }
+    }
+
+    return false;
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::count(const _Tp& key) const noexcept {
+    const uint64_t fp = fingerprint(key);
+    const uint64_t q = fp >> r_bits;
+    const uint16_t r = fp bitand low_mask(r_bits);
+
+    if (not occupied(q)) {
+        return 0;
+    }
+
+    const uint64_t end = runend_or_prev(q);
+    uint64_t copies = 0;
+    for (uint64_t i = run_start(q); i <= end; i++) {
+        copies += remainder(i) == r;
+    }
+
+    return copies;
+}
+
+template <typename _Tp, class HF>
+bool QuotientFilter<_Tp, HF>::remove(const _Tp& key) noexcept {
+    const uint64_t fp = fingerprint(key);
+    const uint64_t q = fp >> r_bits;
+    const uint16_t r = fp bitand low_mask(r_bits);
+
+    if (not occupied(q)) {
+        return false;
+    }
+
+    const uint64_t start = run_start(q), end = runend_or_prev(q);
+    uint64_t victim = start;
+    while (victim <= end and remainder(victim) != r) {
+        victim++;
+    }
+
+    if (victim > end) {
+        return false;
+    }
+
+    uint64_t last = end;
+    for (uint64_t run = q, next = next_occupied(run, last); next <= last; run = next, next = next_occupied(run, last)) {
+        last = select_runend(last + 1, 1);
+    }
+
+    shift_left(victim, last);
+    if (start == end) {
+        set_occupied(q, false);
+    }
+
+    else if (victim == end) {
+        set_runend(end - 1, true);
+    }
+
+    update_offsets(q, last);
+    key_count--;
+    return true;
+}
+
+template <typename _Tp, class HF>
+void QuotientFilter<_Tp, HF>::resize(void) {
+    if (r_bits <= 2) {
+        throw std::length_error("quotient filter cannot grow: remainder bits exhausted");
+    }
+
+    rebuild(q_bits + 1, this, nullptr);
+}
+
+template <typename _Tp, class HF>
+void QuotientFilter<_Tp, HF>::merge(const QuotientFilter& other) {
+    if (q_bits + r_bits != other.q_bits + other.r_bits) {
+        throw std::invalid_argument("cannot merge quotient filters with different fingerprint widths");
+    }
+
+    uint8_t new_q_bits = std::max(q_bits, other.q_bits);
+    while ((key_count + other.key_count) > _QUOTIENTFILTER_MAX_LOAD * (1ULL << new_q_bits)) {
+        new_q_bits++;
+    }
+
+    if (q_bits + r_bits - new_q_bits < 2) {
+        throw std::length_error("quotient filter cannot grow: remainder bits exhausted");
+    }
+
+    rebuild(new_q_bits, this, &other);
+}
+
+template <typename _Tp, class HF>
+double QuotientFilter<_Tp, HF>::load_factor(void) const noexcept {
+    return double(key_count) / n_slots;
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::num_keys(void) const noexcept {
+    return key_count;
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::num_slots(void) const noexcept {
+    return n_slots;
+}
+
+template <typename _Tp, class HF>
+uint8_t QuotientFilter<_Tp, HF>::fingerprint_bits(void) const noexcept {
+    return q_bits + r_bits;
+}
+
+template <typename _Tp, class HF>
+uint64_t QuotientFilter<_Tp, HF>::size_in_bytes(void) const noexcept {
+    return n_blocks * sizeof(QuotientBlock);
+}